@@ -0,0 +1,13 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "abstract_collection_callback.hpp"
+
+namespace Asteria {
+
+Abstract_collection_callback::~Abstract_collection_callback()
+  {
+  }
+
+}
@@ -0,0 +1,28 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_ABSTRACT_COLLECTION_CALLBACK_HPP_
+#define ASTERIA_ABSTRACT_COLLECTION_CALLBACK_HPP_
+
+#include "fwd.hpp"
+#include "collection_statistics.hpp"
+
+namespace Asteria {
+
+class Abstract_collection_callback
+  {
+  public:
+    Abstract_collection_callback() noexcept
+      {
+      }
+    virtual ~Abstract_collection_callback();
+
+  public:
+    // This function is called after a collection of generation `gen` finishes, with statistics of that collection.
+    // It shall not throw exceptions or perform garbage collection.
+    virtual void accept(unsigned gen, const Collection_statistics &stats) const = 0;
+  };
+
+}
+
+#endif
@@ -10,4 +10,19 @@ Abstract_variable_callback::~Abstract_variable_callback()
   {
   }
 
+bool Abstract_variable_callback::accept_function(const D_function & /*func*/) const
+  {
+    return true;
+  }
+
+bool Abstract_variable_callback::accept_array(const D_array & /*arr*/) const
+  {
+    return true;
+  }
+
+bool Abstract_variable_callback::accept_object(const D_object & /*obj*/) const
+  {
+    return true;
+  }
+
 }
@@ -19,6 +19,32 @@ class Abstract_variable_callback
 
   public:
     virtual bool accept(const rocket::refcounted_ptr<Variable> &var) const = 0;
+    // These functions are called before variables that are reachable from `func`, `arr` or `obj` are enumerated. If
+    // they return `false`, those variables are skipped. As a function, or the storage of an array or object, may be
+    // shared by multiple values, the address of the argument identifies the value that refers to it.
+    virtual bool accept_function(const D_function &func) const;
+    virtual bool accept_array(const D_array &arr) const;
+    virtual bool accept_object(const D_object &obj) const;
+  };
+
+// This wraps a function object, which is called with the same arguments as `accept()`.
+template<typename FunctionT>
+  class Variable_callback : public Abstract_variable_callback
+  {
+  private:
+    FunctionT m_func;  // If `FunctionT` is a reference type then this is a reference.
+
+  public:
+    explicit Variable_callback(FunctionT &&func)
+      : m_func(std::forward<FunctionT>(func))
+      {
+      }
+
+  public:
+    bool accept(const rocket::refcounted_ptr<Variable> &var) const override
+      {
+        return this->m_func(var);
+      }
   };
 
 }
@@ -0,0 +1,37 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_COLLECTION_STATISTICS_HPP_
+#define ASTERIA_COLLECTION_STATISTICS_HPP_
+
+#include "fwd.hpp"
+
+namespace Asteria {
+
+// These are statistics of either a single garbage collection or all collections of a generation.
+// A pause is the time spent by a single step of a collection, during which the script is stopped. Time spent by the
+// helper thread concurrently is not included. All times are in microseconds.
+struct Collection_statistics
+  {
+    Uint64 collections;
+    // This is the number of collections whose reachability analysis was performed by the helper thread.
+    Uint64 collections_concurrent;
+    Uint64 pauses;
+    Uint64 pause_time_total;
+    Uint64 pause_time_max;
+    // `pause_histogram[0]` counts pauses that took less than 10 microseconds. `pause_histogram[i]` counts pauses that
+    // took at least `10^i` and less than `10^(i+1)` microseconds. The last element also counts all longer pauses.
+    Array<Uint64, 8> pause_histogram;
+    // Variables that were examined are either freed, promoted to the next generation, untracked because they can no
+    // longer form cycles, or retained in this generation.
+    Uint64 variables_examined;
+    Uint64 variables_freed;
+    Uint64 variables_promoted;
+    Uint64 variables_untracked;
+    // This is an estimate. See `Global_context::set_garbage_collection_thresholds()`.
+    Uint64 bytes_freed;
+  };
+
+}
+
+#endif
@@ -5,44 +5,11 @@
 #include "collector.hpp"
 #include "variable.hpp"
 #include "abstract_variable_callback.hpp"
+#include "abstract_collection_callback.hpp"
 #include "utilities.hpp"
 
 namespace Asteria {
 
-Collector::~Collector()
-  {
-  }
-
-bool Collector::track_variable(const rocket::refcounted_ptr<Variable> &var)
-  {
-    if(this->m_tracked.empty()) {
-      this->m_tracked.reserve(this->m_threshold | 20);
-    }
-    if(!this->m_tracked.insert(var)) {
-      return false;
-    }
-    this->m_counter += 1;
-    this->auto_collect();
-    return true;
-  }
-
-bool Collector::untrack_variable(const rocket::refcounted_ptr<Variable> &var) noexcept
-  {
-    if(!this->m_tracked.erase(var)) {
-      return false;
-    }
-    return true;
-  }
-
-bool Collector::auto_collect()
-  {
-    if(this->m_counter <= this->m_threshold) {
-      return false;
-    }
-    this->collect();
-    return true;
-  }
-
   namespace {
 
   class Sentry
@@ -74,139 +41,1009 @@ bool Collector::auto_collect()
         }
     };
 
-  template<typename FunctionT>
-    class Variable_callback : public Abstract_variable_callback
+  // Variables that are known to be reachable have their `gcref` counters set to this value. As it is a large negative
+  // number, it remains negative after the counter is incremented.
+  constexpr long gcref_shaded = LONG_MIN / 2;
+
+  // This is a shallow estimate, as traversing nested values would be expensive. Storage that is shared by multiple
+  // values is counted once for each of them.
+  Size do_estimate_size(const Variable &var) noexcept
     {
-    private:
-      FunctionT m_func;  // If `FunctionT` is a reference type then this is a reference.
+      const auto &value = var.get_value();
+      const Size size = sizeof(Variable);
+      switch(rocket::weaken_enum(value.type())) {
+        case Value::type_null:
+        case Value::type_boolean:
+        case Value::type_integer:
+        case Value::type_real:
+        case Value::type_opaque:
+        case Value::type_function: {
+          return size;
+        }
+        case Value::type_string: {
+          return size + value.check<D_string>().size();
+        }
+        case Value::type_array: {
+          const auto &alt = value.check<D_array>();
+          const auto elem_size = (alt.mode() == D_array::mode_generic) ? sizeof(Value) : sizeof(D_integer);
+          return size + alt.size() * elem_size;
+        }
+        case Value::type_object: {
+          const auto &alt = value.check<D_object>();
+          return size + alt.size() * (sizeof(String) + sizeof(Value));
+        }
+        default: {
+          ASTERIA_TERMINATE("An unknown value type enumeration `", value.type(), "` has been encountered.");
+        }
+      }
+    }
 
-    public:
-      explicit Variable_callback(FunctionT &&func)
-        : m_func(std::forward<FunctionT>(func))
+  // This function returns the reference count of the function, or the storage of the array or object, in `value`.
+  long do_get_use_count(const Value &value) noexcept
+    {
+      switch(rocket::weaken_enum(value.type())) {
+        case Value::type_function: {
+          return value.check<D_function>()->use_count();
+        }
+        case Value::type_array: {
+          return value.check<D_array>().opt<Persistent_vector<Value>>()->use_count();
+        }
+        case Value::type_object: {
+          return value.check<D_object>().use_count();
+        }
+        default: {
+          ASTERIA_TERMINATE("An unexpected value type enumeration `", value.type(), "` has been encountered.");
+        }
+      }
+    }
+
+  // This function multiplies `value` by two, but the result will not exceed 16 times `base`.
+  Size do_increase_threshold(Size value, Size base) noexcept
+    {
+      const auto limit = (base <= SIZE_MAX / 16) ? base * 16 : SIZE_MAX;
+      return (value >= limit / 2) ? limit : value * 2;
+    }
+  // This function divides `value` by two, but the result will not fall below a quarter of `base`.
+  Size do_decrease_threshold(Size value, Size base) noexcept
+    {
+      return rocket::max(value / 2, base / 4);
+    }
+
+  // This function returns the index into `Collection_statistics::pause_histogram` for a pause of `time` microseconds.
+  Size do_get_histogram_bucket(Uint64 time) noexcept
+    {
+      Size bucket = 0;
+      for(auto limit = Uint64(10); time >= limit; limit *= 10) {
+        if(bucket == Collection_statistics().pause_histogram.size() - 1) {
+          break;
+        }
+        bucket += 1;
+      }
+      return bucket;
+    }
+
+  void do_accumulate_statistics(Collection_statistics &total, const Collection_statistics &stats) noexcept
+    {
+      total.collections += stats.collections;
+      total.collections_concurrent += stats.collections_concurrent;
+      total.pauses += stats.pauses;
+      total.pause_time_total += stats.pause_time_total;
+      total.pause_time_max = rocket::max(total.pause_time_max, stats.pause_time_max);
+      for(Size i = 0; i < total.pause_histogram.size(); ++i) {
+        total.pause_histogram[i] += stats.pause_histogram[i];
+      }
+      total.variables_examined += stats.variables_examined;
+      total.variables_freed += stats.variables_freed;
+      total.variables_promoted += stats.variables_promoted;
+      total.variables_untracked += stats.variables_untracked;
+      total.bytes_freed += stats.bytes_freed;
+    }
+
+  template<typename ElementT, typename FuncT>
+    bool do_for_each_from(Size &cursor, const Vector<ElementT> &elems, FuncT &&func)
+    {
+      while(cursor < elems.size()) {
+        const auto i = cursor++;
+        if(!std::forward<FuncT>(func)(elems[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  }
+
+Collector::~Collector()
+  {
+    if(this->m_helper_active) {
+      this->m_helper.join();
+    }
+    this->detach_variables();
+  }
+
+void Collector::detach_variables() noexcept
+  {
+    // Stop buffering variables, as references may be dropped below.
+    this->m_cand_threshold = 0;
+    // Detach variables from the collection in progress, if any.
+    for(const auto &var : this->m_staging) {
+      var->set_collector_opt(nullptr);
+    }
+    // Untracked variables may outlive this collector.
+    this->m_parked.for_each(
+      [&](Variable &var)
         {
+          var.set_park_collector_opt(nullptr);
+          var.set_candidate_collector_opt(nullptr);
         }
+      );
+    // Variables that have been transferred from another generation may point to another collector.
+    const auto detach = [&](Variable &var)
+      {
+        var.set_candidate_collector_opt(nullptr);
+      };
+    this->m_list_one.for_each(detach);
+    this->m_list_two.for_each(detach);
+    for(const auto &var : this->m_candidates) {
+      var->set_candidate_collector_opt(nullptr);
+      var->set_buffered(false);
+    }
+    this->m_candidates.clear();
+  }
 
-    public:
-      bool accept(const rocket::refcounted_ptr<Variable> &var) const override
+void Collector::set_candidate_threshold(Size threshold) noexcept
+  {
+    this->m_cand_threshold = threshold;
+    if(threshold != 0) {
+      return;
+    }
+    for(const auto &var : this->m_candidates) {
+      var->set_buffered(false);
+    }
+    this->m_candidates.clear();
+  }
+
+bool Collector::track_variable(const rocket::refcounted_ptr<Variable> &var)
+  {
+    if(var->get_value().may_contain_variables()) {
+      if(!this->m_tracked->insert(var)) {
+        return false;
+      }
+      this->do_count_tracked(*var);
+    } else {
+      // This variable cannot form a cycle yet.
+      if(!this->m_parked.insert(var)) {
+        return false;
+      }
+      var->set_park_collector_opt(this);
+    }
+    if(this->m_cand_threshold != 0) {
+      var->set_candidate_collector_opt(this);
+    }
+    this->auto_collect();
+    return true;
+  }
+
+bool Collector::untrack_variable(const rocket::refcounted_ptr<Variable> &var)
+  {
+    if(this->m_tracked->erase(*var)) {
+      return true;
+    }
+    if(this->m_parked.erase(*var)) {
+      var->set_park_collector_opt(nullptr);
+      return true;
+    }
+    if(!this->m_frozen->has(*var)) {
+      return false;
+    }
+    // The reference from `m_frozen` may have been counted, so keep the variable alive until the collection finishes.
+    if(var->get_collector_opt() == this) {
+      this->write_barrier(*var);
+    }
+    if(this->m_frozen_cursor == var.get()) {
+      this->m_frozen_cursor = this->m_frozen->next(*var);
+    }
+    this->m_frozen->erase(*var);
+    return true;
+  }
+
+void Collector::unpark_variable(Variable &var)
+  {
+    ROCKET_ASSERT(var.get_park_collector_opt() == this);
+    var.set_park_collector_opt(nullptr);
+    this->m_parked.erase(var);
+    // N.B. This function may be called in the middle of a modification, so it must not start a collection.
+    this->m_tracked->insert(var.share_this<Variable>());
+    this->do_count_tracked(var);
+  }
+
+void Collector::write_barrier(Variable &var)
+  {
+    ROCKET_ASSERT(var.get_collector_opt() == this);
+    const auto lock = this->do_lock_opt();
+    if(var.get_gcref() < 0) {
+      return;
+    }
+    this->do_shade(var);
+  }
+
+void Collector::buffer_candidate(Variable &var) noexcept
+  {
+    ROCKET_ASSERT(var.get_candidate_collector_opt() == this);
+    if(this->m_cand_threshold == 0) {
+      return;
+    }
+    // Variables that are being examined by `collect_candidates()` need not be buffered.
+    if(var.get_collector_opt() == this) {
+      return;
+    }
+    // This is the number of references that will remain.
+    const auto nref = var.use_count() - 1;
+    if(nref <= 0) {
+      return;
+    }
+    // A variable that cannot be part of a cycle becomes garbage only if it is referenced by nothing but its list.
+    if(!var.get_value().may_contain_variables()) {
+      const auto list = var.get_list_opt();
+      if(!list || list->is_weak() || (nref != 1)) {
+        return;
+      }
+    }
+    try {
+      this->m_candidates.emplace_back(var.share_this<Variable>());
+      var.set_buffered(true);
+    } catch(std::exception &e) {
+      // The variable will be examined by the next full collection.
+      ASTERIA_DEBUG_LOG("Failed to buffer variable: ", e.what());
+    }
+  }
+
+bool Collector::auto_collect()
+  {
+    if(this->m_cand_threshold != 0) {
+      // Generations are not collected automatically.
+      if(this->m_candidates.size() <= this->m_cand_threshold) {
+        return false;
+      }
+      this->collect_candidates();
+      return true;
+    }
+    // Advance the collection in progress, which may be of an older generation.
+    for(auto qcoll = this; qcoll; qcoll = qcoll->m_tied_opt) {
+      if(qcoll->m_phase != phase_idle) {
+        qcoll->collect_step();
+        return true;
+      }
+    }
+    if(!this->do_check_thresholds()) {
+      return false;
+    }
+    // If collections are neither incremental nor concurrent, this performs a full collection.
+    this->collect_step();
+    return true;
+  }
+
+bool Collector::collect_step()
+  {
+    return this->do_collect_some(this->m_step_work_limit, this->m_step_time_limit, false);
+  }
+
+void Collector::finish_collection()
+  {
+    if(this->m_phase == phase_idle) {
+      return;
+    }
+    this->do_collect_some(0, 0, true);
+  }
+
+void Collector::collect()
+  {
+    // Finish the collection in progress, if any, then perform a new one.
+    this->finish_collection();
+    this->do_collect_some(0, 0, true);
+  }
+
+void Collector::wipe_out_variables() noexcept
+  {
+    this->abort_collection();
+    ASTERIA_DEBUG_LOG("Wiping out variables: this = ", static_cast<void *>(this), ", tracked_variables = ", this->m_tracked->size());
+    // Clearing all values breaks all cycles. Variables are kept alive by `m_tracked` until it is cleared.
+    this->m_tracked->for_each(
+      [&](Variable &var)
         {
-          return this->m_func(var);
+          var.reset(D_null(), true);
         }
-    };
+      );
+    this->m_tracked->clear();
+    this->m_counter = 0;
+    this->m_byte_counter = 0;
+  }
+
+class Collector::Step_budget
+  {
+  private:
+    Size m_work_left;
+    bool m_timed;
+    Size m_work_unchecked;
+    std::chrono::steady_clock::time_point m_deadline;
 
-  template<typename FunctionT>
-    inline Variable_callback<FunctionT> do_make_variable_callback(FunctionT &&func)
+  public:
+    Step_budget(Size work_limit, Uint64 time_limit)
+      : m_work_left(work_limit ? work_limit : SIZE_MAX), m_timed(time_limit != 0), m_work_unchecked(0)
       {
-        return Variable_callback<FunctionT>(std::forward<FunctionT>(func));
+        if(this->m_timed) {
+          this->m_deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(time_limit);
+        }
+      }
+
+    Step_budget(const Step_budget &)
+      = delete;
+    Step_budget & operator=(const Step_budget &)
+      = delete;
+
+  public:
+    // This function returns `false` if the budget has been exhausted.
+    bool consume(Size work) noexcept
+      {
+        if(work >= this->m_work_left) {
+          this->m_work_left = 0;
+          return false;
+        }
+        this->m_work_left -= work;
+        if(!this->m_timed) {
+          return true;
+        }
+        // Reading the clock is not free, so do it once in a while.
+        this->m_work_unchecked += work;
+        if(this->m_work_unchecked < 64) {
+          return true;
+        }
+        this->m_work_unchecked = 0;
+        return std::chrono::steady_clock::now() < this->m_deadline;
       }
+  };
 
+class Collector::Counting_callback : public Abstract_variable_callback
+  {
+  private:
+    Collector *m_coll;
+
+  public:
+    explicit Counting_callback(Collector *coll) noexcept
+      : m_coll(coll)
+      {
+      }
+
+  public:
+    bool accept(const rocket::refcounted_ptr<Variable> &var) const override
+      {
+        // Variables that have been made reachable since the collection began are not staged.
+        if(var->get_collector_opt() != this->m_coll) {
+          return false;
+        }
+        var->set_gcref(var->get_gcref() + 1);
+        return false;
+      }
+    bool accept_function(const D_function &func) const override
+      {
+        if(!this->m_coll->do_count_shared(&func, func.get())) {
+          return false;
+        }
+        this->m_coll->m_shared.push_back({ func, 1, false });
+        return true;
+      }
+    bool accept_array(const D_array &arr) const override
+      {
+        const auto &elems = *(arr.opt<Persistent_vector<Value>>());
+        if(!this->m_coll->do_count_shared(&arr, elems.root_id())) {
+          return false;
+        }
+        // If a subtree is shared, it cannot be told where references to it come from.
+        this->m_coll->m_shared.push_back({ arr, 1, elems.has_shared_subtrees() });
+        return true;
+      }
+    bool accept_object(const D_object &obj) const override
+      {
+        if(!this->m_coll->do_count_shared(&obj, obj.storage_id())) {
+          return false;
+        }
+        // If a subtree is shared, it cannot be told where references to it come from.
+        this->m_coll->m_shared.push_back({ obj, 1, obj.has_shared_subtrees() });
+        return true;
+      }
+  };
+
+void Collector::do_count_tracked(const Variable &var) noexcept
+  {
+    this->m_counter += 1;
+    this->m_byte_counter += do_estimate_size(var);
   }
 
-void Collector::collect()
+bool Collector::do_check_thresholds() const noexcept
   {
-    // Ignore recursive requests.
-    const Sentry sentry(this->m_recur);
-    if(!sentry) {
+    if(this->m_counter > this->m_threshold) {
+      return true;
+    }
+    return (this->m_byte_threshold != 0) && (this->m_byte_counter > this->m_byte_threshold);
+  }
+
+void Collector::do_adapt_thresholds() noexcept
+  {
+    const auto total = this->m_survived + this->m_freed;
+    if(!this->m_adaptive || (total == 0)) {
+      return;
+    }
+    if(this->m_survived * 2 > total) {
+      // Most variables have survived, so collections are not productive. Make them less frequent.
+      this->m_threshold = do_increase_threshold(this->m_threshold, this->m_base_threshold);
+      this->m_byte_threshold = do_increase_threshold(this->m_byte_threshold, this->m_base_byte_threshold);
+    } else if(this->m_survived * 8 < total) {
+      // Most variables have been wiped out. Make collections more frequent, so garbage does not pile up.
+      this->m_threshold = do_decrease_threshold(this->m_threshold, this->m_base_threshold);
+      this->m_byte_threshold = do_decrease_threshold(this->m_byte_threshold, this->m_base_byte_threshold);
+    }
+    ASTERIA_DEBUG_LOG("  Thresholds adjusted: survived = ", this->m_survived, ", freed = ", this->m_freed,
+                      ", threshold = ", this->m_threshold, ", byte_threshold = ", this->m_byte_threshold);
+  }
+
+std::unique_lock<std::mutex> Collector::do_lock_opt()
+  {
+    // Variables are shared with the helper thread only while it is running.
+    if(!this->m_helper_active) {
+      return { };
+    }
+    return std::unique_lock<std::mutex>(this->m_mutex);
+  }
+
+bool Collector::do_run_helper(bool wait)
+  {
+    if(!this->m_helper_active) {
+      ASTERIA_DEBUG_LOG("Starting helper thread: this = ", static_cast<void *>(this));
+      this->m_helper_done.store(false, std::memory_order_relaxed);
+      this->m_helper_except = nullptr;
+      // This has to be set before the thread is created.
+      this->m_helper_active = true;
+      this->m_stats.collections_concurrent = 1;
+      this->m_helper = std::thread(
+        [this]
+          {
+            try {
+              Step_budget budget(0, 0);
+              this->m_cursor = 0;
+              this->do_count(budget);
+              this->m_cursor = 0;
+              this->do_mark(budget);
+            } catch(...) {
+              this->m_helper_except = std::current_exception();
+            }
+            this->m_helper_done.store(true, std::memory_order_release);
+          }
+        );
+    }
+    if(!wait && !this->m_helper_done.load(std::memory_order_acquire)) {
+      return false;
+    }
+    this->m_helper.join();
+    this->m_helper_active = false;
+    ASTERIA_DEBUG_LOG("Helper thread finished: this = ", static_cast<void *>(this));
+    if(this->m_helper_except) {
+      std::rethrow_exception(this->m_helper_except);
+    }
+    return true;
+  }
+
+void Collector::do_shade(Variable &var)
+  {
+    // Mark `var` as reachable. Variables reachable from it will be marked when the copy of its value is scanned.
+    var.set_gcref(gcref_shaded);
+    const auto &value = var.get_value();
+    if(!value.may_contain_variables()) {
       return;
     }
+    this->m_grey.emplace_back(value);
+  }
+
+void Collector::do_shade_reachable(const Value &value)
+  {
+    // Mark all variables that `value` refers to as reachable.
+    value.enumerate_variables_with(
+      [&](const rocket::refcounted_ptr<Variable> &var)
+        {
+          // Variables that are not being examined are ignored.
+          if(var->get_collector_opt() != this) {
+            return false;
+          }
+          if(var->get_gcref() < 0) {
+            return false;
+          }
+          this->do_shade(*var);
+          return false;
+        }
+      );
+  }
+
+bool Collector::do_scan_grey(Step_budget &budget)
+  {
+    for(;;) {
+      // N.B. The copy is destroyed after the lock is released, as this may drop references to variables.
+      Value value;
+      const auto lock = this->do_lock_opt();
+      // The helper thread may append values to `m_grey`.
+      if(this->m_grey.empty()) {
+        return true;
+      }
+      value = std::move(this->m_grey.mut_back());
+      this->m_grey.pop_back();
+      this->do_shade_reachable(value);
+      if(!budget.consume(1)) {
+        return false;
+      }
+    }
+  }
+
+bool Collector::do_count_shared(const void *ref, const void *id)
+  {
+    // `ref` is the address of a value that refers to `id`, which identifies a function or storage.
+    if(!id) {
+      return false;
+    }
+    // A value may be reached multiple times if storage containing it is shared.
+    if(!this->m_shared_refs.try_emplace(ref, true).second) {
+      return false;
+    }
+    const auto result = this->m_shared_indices.try_emplace(id, this->m_shared.size());
+    if(!result.second) {
+      // Variables that are reachable from it have been counted.
+      this->m_shared.mut(result.first->second).nref += 1;
+      return false;
+    }
+    // The caller shall append a copy of the value to `m_shared`, then enumerate variables that it refers to.
+    return true;
+  }
+
+void Collector::do_clear_staging() noexcept
+  {
+    this->m_staging.clear();
+    this->m_cursor = 0;
+    this->m_shared.clear();
+    this->m_shared_indices.clear();
+    this->m_shared_refs.clear();
+    this->m_shared_cursor = 0;
+    this->m_grey.clear();
+  }
+
+void Collector::do_begin()
+  {
     // The algorithm here is basically described at
     //   https://pythoninternal.wordpress.com/2014/08/04/the-garbage-collector/
     // However, we initialize `gcref` to zero then increment it, rather than initialize `gcref` to the reference count then decrement it.
     // This saves us a phase below.
-    ASTERIA_DEBUG_LOG("Garbage collection begins: this = ", static_cast<void *>(this), ", tracked_variables = ", this->m_tracked.size());
-    this->m_staging.clear();
-    this->m_staging.reserve(this->m_tracked.size() * 9 / 8);
+    // If the collection is performed in steps, the mutator may run between them. Variables that are modified (see
+    // `Variable::bump_stamp()`) during the collection are marked by the write barrier, which keeps a copy of the value
+    // before modification, and variables reachable from the copy are marked by subsequent steps, so a reference that is
+    // moved elsewhere is never lost.
+    // If phases 2 and 3 are performed by the helper thread, it locks `m_mutex` before inspecting a variable, which the
+    // write barrier also locks. The helper thread never inspects values of variables that have been marked, as they
+    // may be modified by the mutator without notifying the collector.
+    ASTERIA_DEBUG_LOG("Garbage collection begins: this = ", static_cast<void *>(this), ", tracked_variables = ", this->m_tracked->size());
+    ROCKET_ASSERT(this->m_frozen->empty());
+    ROCKET_ASSERT(this->m_staging.empty());
+    // Variables that are tracked after this point will not be examined by this collection.
+    std::swap(this->m_tracked, this->m_frozen);
+    this->m_frozen_cursor = this->m_frozen->first();
+    this->m_staging.reserve(this->m_frozen->size() * 9 / 8);
+    this->m_counter = 0;
+    this->m_byte_counter = 0;
+    this->m_survived = 0;
+    this->m_freed = 0;
+    this->m_stats = Collection_statistics();
+    this->m_stats.collections = 1;
+    this->m_phase = phase_gather;
+  }
+
+Size Collector::do_stage(Variable &root)
+  {
+    // References from the buffer of candidates do not keep variables alive. See `buffer_candidate()`.
+    // Directly reachable.
+    this->m_staging.emplace_back(root.share_this<Variable>());
+    root.set_gcref(root.is_buffered());
+    root.set_collector_opt(this);
+    Size count = 1;
+    // Indirectly reachable.
+    root.enumerate_variables_with(
+      [&](const rocket::refcounted_ptr<Variable> &var)
+        {
+          if(var->get_collector_opt() == this) {
+            return false;
+          }
+          this->m_staging.emplace_back(var);
+          var->set_gcref(var->is_buffered());
+          var->set_collector_opt(this);
+          count += 1;
+          return true;
+        }
+      );
+    return count;
+  }
+
+bool Collector::do_gather(Step_budget &budget)
+  {
     ///////////////////////////////////////////////////////////////////////////
     // Phase 1
     //   Add variables that are either tracked or reachable from tracked ones
-    //   into the staging area.
+    //   into the staging area, then drop references directly from `m_frozen`.
     ///////////////////////////////////////////////////////////////////////////
-    this->m_tracked.for_each(
-      [&](const rocket::refcounted_ptr<Variable> &root)
-        {
-          // Directly reachable.
-          root->set_gcref(0);
-          this->m_staging.insert(root);
-          // Indirectly reachable.
-          root->enumerate_variables(do_make_variable_callback(
-            [&](const rocket::refcounted_ptr<Variable> &var)
-              {
-                var->set_gcref(0);
-                return this->m_staging.insert(var);
-              }
-            ));
-        }
-      );
+    while(this->m_frozen_cursor) {
+      const auto root = this->m_frozen_cursor;
+      this->m_frozen_cursor = this->m_frozen->next(*root);
+      Size work = 1;
+      if(root->get_collector_opt() != this) {
+        work = this->do_stage(*root);
+      }
+      root->set_gcref(root->get_gcref() + 1);
+      if(!budget.consume(work)) {
+        return false;
+      }
+    }
     ASTERIA_DEBUG_LOG("  Number of variables gathered in total: ", this->m_staging.size());
+    return true;
+  }
+
+bool Collector::do_count(Step_budget &budget)
+  {
     ///////////////////////////////////////////////////////////////////////////
     // Phase 2
-    //   Drop references directly from `m_tracked`.
+    //   Drop references directly or indirectly from `m_staging`.
     ///////////////////////////////////////////////////////////////////////////
-    this->m_tracked.for_each(
+    const auto done = do_for_each_from(this->m_cursor, this->m_staging,
       [&](const rocket::refcounted_ptr<Variable> &root)
         {
+          const auto lock = this->do_lock_opt();
+          if(root->get_gcref() < 0) {
+            // This variable has been marked by the write barrier, so its value may have been modified and shall not
+            // be inspected. All variables that were reachable from it will be marked when the copy is scanned.
+            return budget.consume(1);
+          }
+          // Directly reachable.
           root->set_gcref(root->get_gcref() + 1);
-          return false;
+          // Indirectly reachable.
+          // N.B. Variables that are captured by a function are counted once, no matter how many values refer to it.
+          root->enumerate_variables(Counting_callback(this));
+          return budget.consume(1);
         }
       );
+    return done;
+  }
+
+bool Collector::do_mark(Step_budget &budget)
+  {
     ///////////////////////////////////////////////////////////////////////////
     // Phase 3
-    //   Drop references directly or indirectly from `m_staging`.
+    //   Mark variables whose `gcref` counters are less than their reference
+    //   counts, which are referenced from somewhere else, and variables that
+    //   are reachable from them. Shared functions and storage are handled
+    //   likewise.
     ///////////////////////////////////////////////////////////////////////////
-    this->m_staging.for_each(
-      [&](const rocket::refcounted_ptr<Variable> &root)
+    const auto shared_done = do_for_each_from(this->m_shared_cursor, this->m_shared,
+      [&](const Shared_value &shared)
         {
-          // Directly reachable.
-          root->set_gcref(root->get_gcref() + 1);
-          // Indirectly reachable.
-          root->enumerate_variables(do_make_variable_callback(
-            [&](const rocket::refcounted_ptr<Variable> &var)
-              {
-                var->set_gcref(var->get_gcref() + 1);
-                return false;
-              }
-            ));
+          // N.B. `m_shared` holds a reference, which was not counted.
+          if(!shared.pinned && (static_cast<long>(shared.nref) + 1 >= do_get_use_count(shared.value))) {
+            // This may be unreachable.
+            return budget.consume(1);
+          }
+          const auto lock = this->do_lock_opt();
+          this->do_shade_reachable(shared.value);
+          return budget.consume(1);
         }
       );
-#ifdef ROCKET_DEBUG
-    this->m_staging.for_each(
+    if(!shared_done) {
+      return false;
+    }
+    const auto done = do_for_each_from(this->m_cursor, this->m_staging,
       [&](const rocket::refcounted_ptr<Variable> &root)
         {
-          ROCKET_ASSERT(root->get_gcref() <= root.use_count());
+          const auto lock = this->do_lock_opt();
+          const auto gcref = root->get_gcref();
+          if(gcref < 0) {
+            // This variable has been marked already.
+            // N.B. References that have been stored into it since then were not counted, so variables that they
+            // refer to will be marked on their own.
+            return budget.consume(1);
+          }
+          ROCKET_ASSERT(gcref <= root.use_count());
+          if(gcref >= root.use_count()) {
+            // This variable may be unreachable. Don't mark it unless it is reachable from another variable.
+            return budget.consume(1);
+          }
+          this->do_shade(*root);
+          return budget.consume(1);
         }
       );
-#endif
+    return done;
+  }
+
+bool Collector::do_sweep(Step_budget &budget)
+  {
     ///////////////////////////////////////////////////////////////////////////
     // Phase 4
-    //   Wipe out unreachable variables, whose `gcref` counters exceed
-    //   their reference counts.
+    //   Wipe out unreachable variables, which have not been marked.
     ///////////////////////////////////////////////////////////////////////////
-    bool collect_next = false;
     const auto tied = this->m_tied_opt;
-    this->m_staging.for_each(
+    const auto done = do_for_each_from(this->m_cursor, this->m_staging,
       [&](const rocket::refcounted_ptr<Variable> &root)
         {
-          if(root->get_gcref() >= root.use_count()) {
+          root->set_collector_opt(nullptr);
+          this->m_stats.variables_examined += 1;
+          if(root->get_gcref() >= 0) {
             ASTERIA_DEBUG_LOG("  Collecting unreachable variable: ", root->get_value());
+            this->m_stats.variables_freed += 1;
+            this->m_stats.bytes_freed += do_estimate_size(*root);
             root->reset(D_null(), true);
-            this->m_tracked.erase(root);
-            return;
+            if(this->m_frozen->erase(*root)) {
+              this->m_freed += 1;
+            }
+            return budget.consume(1);
+          }
+          // Variables that are not tracked by this collector are left alone.
+          if(!this->m_frozen->has(*root)) {
+            return budget.consume(1);
+          }
+          this->m_survived += 1;
+          if(!root->get_value().may_contain_variables()) {
+            // This variable cannot form a cycle until it is modified, so it need not be examined any more.
+            ASTERIA_DEBUG_LOG("  Untracking acyclic variable: ", root->get_value());
+            this->m_frozen->erase(*root);
+            this->m_parked.insert(root);
+            root->set_park_collector_opt(this);
+            this->m_stats.variables_untracked += 1;
+            return budget.consume(1);
           }
           if(tied) {
             ASTERIA_DEBUG_LOG("  Transferring variable to the next generation: ", root->get_value());
-            tied->m_tracked.insert(root);
-            ++(tied->m_counter);
-            collect_next |= tied->m_counter > tied->m_threshold;
-            this->m_tracked.erase(root);
-            return;
+            this->m_frozen->transfer(*(tied->m_tracked), *root);
+            tied->do_count_tracked(*root);
+            this->m_stats.variables_promoted += 1;
+            return budget.consume(1);
           }
+          this->m_frozen->transfer(*(this->m_tracked), *root);
+          return budget.consume(1);
         }
       );
-    if(collect_next) {
+    return done;
+  }
+
+void Collector::do_end()
+  {
+    ROCKET_ASSERT(this->m_frozen->empty());
+    this->do_clear_staging();
+    this->m_phase = phase_idle;
+    ASTERIA_DEBUG_LOG("Garbage collection ends: this = ", static_cast<void *>(this));
+    this->do_adapt_thresholds();
+  }
+
+void Collector::abort_collection() noexcept
+  {
+    if(this->m_phase == phase_idle) {
+      return;
+    }
+    ASTERIA_DEBUG_LOG("Garbage collection aborted: this = ", static_cast<void *>(this));
+    if(this->m_helper_active) {
+      // The helper thread cannot be interrupted. As it only reads values, let it finish, then discard its results.
+      this->m_helper.join();
+      this->m_helper_active = false;
+      this->m_helper_except = nullptr;
+    }
+    for(const auto &var : this->m_staging) {
+      var->set_collector_opt(nullptr);
+    }
+    this->do_clear_staging();
+    // Variables that were being examined are tracked again.
+    while(const auto var = this->m_frozen->first()) {
+      this->m_frozen->transfer(*(this->m_tracked), *var);
+    }
+    this->m_frozen_cursor = nullptr;
+    this->m_phase = phase_idle;
+  }
+
+bool Collector::do_step(Step_budget &budget, bool wait)
+  {
+    // Scan values that have been copied by the write barrier since the last step, so they do not pile up.
+    if(!this->do_scan_grey(budget)) {
+      return false;
+    }
+    for(;;) {
+      switch(rocket::weaken_enum(this->m_phase)) {
+        case phase_idle: {
+          return true;
+        }
+        case phase_gather: {
+          if(!this->do_gather(budget)) {
+            return false;
+          }
+          this->m_phase = phase_count;
+          this->m_cursor = 0;
+          break;
+        }
+        case phase_count: {
+          if(this->m_concurrent || this->m_helper_active) {
+            // Phases 2 and 3 are performed by the helper thread.
+            if(!this->do_run_helper(wait)) {
+              return false;
+            }
+            this->m_phase = phase_sweep;
+            this->m_cursor = 0;
+            break;
+          }
+          if(!this->do_count(budget)) {
+            return false;
+          }
+          this->m_phase = phase_mark;
+          this->m_cursor = 0;
+          break;
+        }
+        case phase_mark: {
+          if(!this->do_mark(budget)) {
+            return false;
+          }
+          this->m_phase = phase_sweep;
+          this->m_cursor = 0;
+          break;
+        }
+        case phase_sweep: {
+          // All variables that are reachable from marked ones must have been marked before any is wiped out.
+          if(!this->do_scan_grey(budget)) {
+            return false;
+          }
+          if(!this->do_sweep(budget)) {
+            return false;
+          }
+          this->do_end();
+          break;
+        }
+        default: {
+          ASTERIA_TERMINATE("An unknown collection phase enumeration `", this->m_phase, "` has been encountered.");
+        }
+      }
+    }
+  }
+
+void Collector::do_gather_candidates()
+  {
+    ///////////////////////////////////////////////////////////////////////////
+    // Phase 1
+    //   Add buffered variables and variables that are reachable from them
+    //   into the staging area, then drop references directly from lists
+    //   that would be erased if they were wiped out.
+    ///////////////////////////////////////////////////////////////////////////
+    // Buffered variables are moved into the staging area, so references from the buffer are not counted.
+    auto roots = std::move(this->m_candidates);
+    this->m_candidates.clear();
+    for(const auto &root : roots) {
+      root->set_buffered(false);
+    }
+    for(const auto &root : roots) {
+      if(root->get_collector_opt() == this) {
+        continue;
+      }
+      this->do_stage(*root);
+    }
+    roots.clear();
+    for(const auto &var : this->m_staging) {
+      const auto list = var->get_list_opt();
+      if(!list || list->is_weak()) {
+        continue;
+      }
+      var->set_gcref(var->get_gcref() + 1);
+    }
+    ASTERIA_DEBUG_LOG("  Number of variables gathered from buffered ones: ", this->m_staging.size());
+  }
+
+void Collector::do_sweep_candidates()
+  {
+    ///////////////////////////////////////////////////////////////////////////
+    // Phase 4
+    //   Wipe out unreachable variables, which have not been marked, and
+    //   remove them from their lists. Others are left alone.
+    ///////////////////////////////////////////////////////////////////////////
+    for(const auto &var : this->m_staging) {
+      var->set_collector_opt(nullptr);
+      this->m_stats.variables_examined += 1;
+      if(var->get_gcref() < 0) {
+        continue;
+      }
+      ASTERIA_DEBUG_LOG("  Collecting unreachable variable: ", var->get_value());
+      this->m_stats.variables_freed += 1;
+      this->m_stats.bytes_freed += do_estimate_size(*var);
+      var->reset(D_null(), true);
+      const auto list = var->get_list_opt();
+      if(list && !list->is_weak()) {
+        list->erase(*var);
+      }
+    }
+    this->do_clear_staging();
+  }
+
+void Collector::collect_candidates()
+  {
+    // Trial deletion cannot be interleaved with other collections.
+    for(auto qcoll = this; qcoll; qcoll = qcoll->m_tied_opt) {
+      qcoll->finish_collection();
+    }
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry) {
+      return;
+    }
+    for(auto qcoll = this; qcoll; qcoll = qcoll->m_tied_opt) {
+      if(qcoll->m_phase != phase_idle) {
+        return;
+      }
+    }
+    ASTERIA_DEBUG_LOG("Candidate collection begins: this = ", static_cast<void *>(this), ", buffered_variables = ", this->m_candidates.size());
+    const auto since = std::chrono::steady_clock::now();
+    this->m_stats = Collection_statistics();
+    this->m_stats.collections = 1;
+    // Phases 2 and 3 are shared with generational collections.
+    Step_budget budget(0, 0);
+    this->do_gather_candidates();
+    this->m_cursor = 0;
+    this->do_count(budget);
+    this->m_cursor = 0;
+    this->do_mark(budget);
+    this->do_scan_grey(budget);
+    this->m_cursor = 0;
+    this->do_sweep_candidates();
+    ASTERIA_DEBUG_LOG("Candidate collection ends: this = ", static_cast<void *>(this));
+    this->do_record_pause(since);
+    this->do_publish_statistics();
+  }
+
+void Collector::do_record_pause(std::chrono::steady_clock::time_point since) noexcept
+  {
+    const auto time = static_cast<Uint64>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - since).count());
+    auto &stats = this->m_stats;
+    stats.pauses += 1;
+    stats.pause_time_total += time;
+    stats.pause_time_max = rocket::max(stats.pause_time_max, time);
+    stats.pause_histogram[do_get_histogram_bucket(time)] += 1;
+  }
+
+void Collector::do_publish_statistics()
+  {
+    do_accumulate_statistics(this->m_stats_total, this->m_stats);
+    ASTERIA_DEBUG_LOG("Garbage collection statistics: gen = ", this->m_gen, ", pauses = ", this->m_stats.pauses,
+                      ", pause_time_total = ", this->m_stats.pause_time_total, ", freed = ", this->m_stats.variables_freed);
+    const auto callback = this->m_callback_opt;
+    if(callback) {
+      callback->accept(this->m_gen, this->m_stats);
+    }
+  }
+
+bool Collector::do_collect_some(Size work_limit, Uint64 time_limit, bool wait)
+  {
+    // Ignore recursive requests.
+    const Sentry sentry(this->m_recur);
+    if(!sentry) {
+      return false;
+    }
+    const auto since = std::chrono::steady_clock::now();
+    if(this->m_phase == phase_idle) {
+      this->do_begin();
+    }
+    Step_budget budget(work_limit, time_limit);
+    const auto done = this->do_step(budget, wait);
+    this->do_record_pause(since);
+    if(!done) {
+      return false;
+    }
+    this->do_publish_statistics();
+    // Collect the next generation if it has received too many variables or too much storage.
+    const auto tied = this->m_tied_opt;
+    if(tied && tied->do_check_thresholds()) {
       tied->auto_collect();
     }
-    ASTERIA_DEBUG_LOG("Garbage collection ends: this = ", static_cast<void *>(this));
-    this->m_counter = 0;
-    this->m_staging.clear();
+    return true;
   }
 
 }
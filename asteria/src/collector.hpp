@@ -5,23 +5,116 @@
 #define ASTERIA_COLLECTOR_HPP_
 
 #include "fwd.hpp"
-#include "variable_hashset.hpp"
+#include "variable_list.hpp"
+#include "collection_statistics.hpp"
+#include <thread>
+#include <chrono>
+#include <mutex>
 
 namespace Asteria {
 
 class Collector
   {
+  public:
+    enum Phase : Uint8
+      {
+        phase_idle    = 0,
+        phase_gather  = 1,
+        phase_count   = 2,
+        phase_mark    = 3,
+        phase_sweep   = 4,
+      };
+
   private:
+    struct Shared_value
+      {
+        Value value;  // This keeps the function or storage alive.
+        Size nref;  // This is the number of values of staged variables that refer to it.
+        bool pinned;  // If this is set, it may be reachable from somewhere else regardless of `nref`.
+      };
+
+  private:
+    unsigned m_gen;
     Collector *m_tied_opt;
+    // A collection is triggered when the number of variables, or the estimated number of bytes of storage, that this
+    // collector has received since the last collection exceeds the corresponding threshold. A byte threshold of zero
+    // means no limit. If `m_adaptive` is set, thresholds are adjusted after each collection according to the fraction
+    // of variables that survive it, within a range from a quarter to sixteen times the base values.
+    Size m_base_threshold;
+    Size m_base_byte_threshold;
+    bool m_adaptive;
     Size m_threshold;
+    Size m_byte_threshold;
     Size m_counter;
+    Size m_byte_counter;
     long m_recur;
-    Variable_hashset m_tracked;
-    Variable_hashset m_staging;
+    // If either limit is non-zero, collections are performed in steps, each of which is bounded by the number of
+    // variables processed and the time elapsed in microseconds. A limit of zero means no limit.
+    Size m_step_work_limit;
+    Uint64 m_step_time_limit;
+    // If this is set, phases 2 and 3 are performed by a helper thread, while the mutator continues.
+    bool m_concurrent;
+    // Tracked variables are stored in one of these lists, pointed to by `m_tracked`. When a collection begins, the
+    // other list takes over, so variables that are tracked afterwards can be told from others in O(1) time.
+    Variable_list m_list_one;
+    Variable_list m_list_two;
+    Variable_list *m_tracked;
+    // Variables whose values cannot form cycles are not tracked, but are kept in this weak list instead, so they can be
+    // tracked again when they are modified. They are never examined by collections, unless they are reachable from
+    // tracked ones.
+    Variable_list m_parked;
+    // If this is non-zero, variables that are tracked by this collector are buffered as possible roots of cycles when
+    // references to them are dropped, and generations are no longer collected automatically. Instead, only variables
+    // that are reachable from buffered ones are examined, when more than this number of variables have been buffered.
+    Size m_cand_threshold;
+    Vector<rocket::refcounted_ptr<Variable>> m_candidates;
+
+    // These are used by the collection in progress.
+    Phase m_phase;
+    Variable_list *m_frozen;  // Variables that were tracked when the collection began.
+    Variable *m_frozen_cursor;
+    Vector<rocket::refcounted_ptr<Variable>> m_staging;
+    Size m_cursor;
+    // A function, or the storage of an array or object, may be shared by multiple values, but it refers to variables
+    // only once. These are copies of values that refer to such things that are reachable from staged variables, each
+    // of which is paired with the number of such values. Variables that are reachable from something that is also
+    // referred to from somewhere else are reachable.
+    Vector<Shared_value> m_shared;
+    rocket::cow_hashmap<const void *, Size> m_shared_indices;  // Indices into `m_shared`.
+    rocket::cow_hashmap<const void *, bool> m_shared_refs;  // Values that have been counted.
+    Size m_shared_cursor;
+    // These are copies of values of variables that have been marked, which are scanned in steps, so variables that were
+    // reachable from them will be marked, too. Copies are taken when variables are marked, as they may be modified
+    // afterwards. Only the mutator scans them, as they may hold the last references to storage.
+    Vector<Value> m_grey;
+    Size m_survived;  // The number of variables in `m_frozen` that have survived.
+    Size m_freed;  // The number of variables in `m_frozen` that have been wiped out.
+    Collection_statistics m_stats;  // Statistics of the collection in progress, or the last one.
+
+    // These are statistics of all collections that have finished. The callback is invoked after each of them.
+    Collection_statistics m_stats_total;
+    const Abstract_collection_callback *m_callback_opt;
+
+    // These are used by the helper thread.
+    // `m_mutex` protects `gcref` counters of staged variables, as well as their values if they have not been marked.
+    bool m_helper_active;
+    std::atomic<bool> m_helper_done;
+    std::exception_ptr m_helper_except;
+    std::mutex m_mutex;
+    std::thread m_helper;
 
   public:
-    Collector(Collector *tied_opt, Size threshold) noexcept
-      : m_tied_opt(tied_opt), m_threshold(threshold), m_counter(0), m_recur(0)
+    // `gen` is the generation number that is passed to the collection callback.
+    Collector(unsigned gen, Collector *tied_opt, Size threshold, Size byte_threshold) noexcept
+      : m_gen(gen), m_tied_opt(tied_opt), m_base_threshold(threshold), m_base_byte_threshold(byte_threshold), m_adaptive(false),
+        m_threshold(threshold), m_byte_threshold(byte_threshold), m_counter(0), m_byte_counter(0), m_recur(0),
+        m_step_work_limit(0), m_step_time_limit(0), m_concurrent(false),
+        m_tracked(&(this->m_list_one)), m_parked(true), m_cand_threshold(0), m_candidates(),
+        m_phase(phase_idle), m_frozen(&(this->m_list_two)), m_frozen_cursor(nullptr), m_staging(), m_cursor(0),
+        m_shared(), m_shared_indices(), m_shared_refs(), m_shared_cursor(0), m_grey(),
+        m_survived(0), m_freed(0), m_stats(),
+        m_stats_total(), m_callback_opt(nullptr),
+        m_helper_active(false), m_helper_done(false)
       {
       }
     ~Collector();
@@ -31,7 +124,39 @@ class Collector
     Collector & operator=(const Collector &)
       = delete;
 
+  private:
+    class Step_budget;
+    class Counting_callback;
+
+    void do_count_tracked(const Variable &var) noexcept;
+    bool do_check_thresholds() const noexcept;
+    void do_adapt_thresholds() noexcept;
+    std::unique_lock<std::mutex> do_lock_opt();
+    bool do_run_helper(bool wait);
+    void do_shade(Variable &var);
+    void do_shade_reachable(const Value &value);
+    bool do_scan_grey(Step_budget &budget);
+    bool do_count_shared(const void *ref, const void *id);
+    void do_clear_staging() noexcept;
+    void do_begin();
+    Size do_stage(Variable &root);
+    bool do_gather(Step_budget &budget);
+    bool do_count(Step_budget &budget);
+    bool do_mark(Step_budget &budget);
+    bool do_sweep(Step_budget &budget);
+    void do_end();
+    void do_gather_candidates();
+    void do_sweep_candidates();
+    bool do_step(Step_budget &budget, bool wait);
+    void do_record_pause(std::chrono::steady_clock::time_point since) noexcept;
+    void do_publish_statistics();
+    bool do_collect_some(Size work_limit, Uint64 time_limit, bool wait);
+
   public:
+    unsigned get_generation() const noexcept
+      {
+        return this->m_gen;
+      }
     Collector * get_tied_collector_opt() const noexcept
       {
         return this->m_tied_opt;
@@ -41,20 +166,135 @@ class Collector
         this->m_tied_opt = tied_opt;
       }
 
+    // These functions return the thresholds in effect, which may have been adjusted.
     Size get_threshold() const noexcept
       {
         return this->m_threshold;
       }
-    void set_threshold(Size threshold) noexcept
+    Size get_byte_threshold() const noexcept
       {
+        return this->m_byte_threshold;
+      }
+    // This function sets the base thresholds, which take effect immediately.
+    void set_thresholds(Size threshold, Size byte_threshold) noexcept
+      {
+        this->m_base_threshold = threshold;
+        this->m_base_byte_threshold = byte_threshold;
         this->m_threshold = threshold;
+        this->m_byte_threshold = byte_threshold;
+      }
+    bool is_adaptive() const noexcept
+      {
+        return this->m_adaptive;
+      }
+    void set_adaptive(bool adaptive) noexcept
+      {
+        this->m_adaptive = adaptive;
+        if(adaptive) {
+          return;
+        }
+        this->m_threshold = this->m_base_threshold;
+        this->m_byte_threshold = this->m_base_byte_threshold;
+      }
+
+    Size get_candidate_threshold() const noexcept
+      {
+        return this->m_cand_threshold;
+      }
+    // Setting the threshold to zero discards all buffered variables. Variables that have been tracked before the
+    // threshold is set to a non-zero value are not buffered.
+    void set_candidate_threshold(Size threshold) noexcept;
+
+    bool is_incremental() const noexcept
+      {
+        return (this->m_step_work_limit != 0) || (this->m_step_time_limit != 0);
+      }
+    Size get_step_work_limit() const noexcept
+      {
+        return this->m_step_work_limit;
+      }
+    Uint64 get_step_time_limit() const noexcept
+      {
+        return this->m_step_time_limit;
+      }
+    void set_step_limits(Size work_limit, Uint64 time_limit) noexcept
+      {
+        this->m_step_work_limit = work_limit;
+        this->m_step_time_limit = time_limit;
+      }
+
+    bool is_concurrent() const noexcept
+      {
+        return this->m_concurrent;
+      }
+    void set_concurrent(bool concurrent) noexcept
+      {
+        this->m_concurrent = concurrent;
+      }
+
+    // This function returns statistics of all collections that have finished. Pauses of the collection in progress, if
+    // any, are not included.
+    const Collection_statistics & get_statistics() const noexcept
+      {
+        return this->m_stats_total;
+      }
+    // This function returns statistics of the collection in progress, or the last one if there is none.
+    const Collection_statistics & get_last_statistics() const noexcept
+      {
+        return this->m_stats;
+      }
+    const Abstract_collection_callback * get_callback_opt() const noexcept
+      {
+        return this->m_callback_opt;
+      }
+    // The callback is not owned by this collector and shall outlive it.
+    void set_callback_opt(const Abstract_collection_callback *callback_opt) noexcept
+      {
+        this->m_callback_opt = callback_opt;
+      }
+
+    Phase get_phase() const noexcept
+      {
+        return this->m_phase;
+      }
+    bool is_collecting() const noexcept
+      {
+        return this->m_phase != phase_idle;
       }
 
     bool track_variable(const rocket::refcounted_ptr<Variable> &var);
-    bool untrack_variable(const rocket::refcounted_ptr<Variable> &var) noexcept;
+    bool untrack_variable(const rocket::refcounted_ptr<Variable> &var);
+    // This function is called when a variable that has been untracked by this collector may become able to form a
+    // cycle. See `Variable::prepare_modification()`.
+    void unpark_variable(Variable &var);
+
+    // This function is called before a reference to a variable that has been tracked by this collector is dropped.
+    // The variable is buffered if it may be part of a cycle, or if nothing other than this collector will refer to it.
+    void buffer_candidate(Variable &var) noexcept;
+
+    // This function is called before a variable that is being examined by the collection in progress is modified.
+    // The variable, together with all variables reachable from it, will survive the collection. The variable is marked
+    // immediately, and variables reachable from it are marked by subsequent steps.
+    void write_barrier(Variable &var);
 
     bool auto_collect();
+    // This function performs a step of the collection in progress, or begins a new collection if there is none.
+    // It returns `true` if the collection has finished. It does not wait for the helper thread.
+    bool collect_step();
+    // This function finishes the collection in progress, if any.
+    void finish_collection();
     void collect();
+    // This function finishes the collection in progress, if any, then examines variables that are reachable from
+    // buffered ones and wipes out those that are unreachable. Other variables are not examined.
+    void collect_candidates();
+    // This function abandons the collection in progress, if any. Variables that were being examined are tracked again.
+    void abort_collection() noexcept;
+    // This function abandons the collection in progress, if any, then wipes out all variables that are tracked by this
+    // collector without analyzing their reachability, and stops tracking them.
+    void wipe_out_variables() noexcept;
+    // This function clears pointers to collectors in all variables that this collector tracks, so they may outlive it.
+    // Buffering is disabled, and all buffered variables are discarded.
+    void detach_variables() noexcept;
   };
 
 }
@@ -67,7 +67,8 @@ void Executive_context::initialize_for_function(Global_context &global, const Fu
     do_set_constant(this->m_line, D_integer(head.get_line()));
     do_set_constant(this->m_func, D_string(head.get_func()));
     // Set the `this` parameter.
-    this->m_self = std::move(self);
+    // Closures in this function may outlive the AST of the caller, so references to constants in it are copied.
+    this->m_self = std::move(self.convert_to_constant());
     // Materialie other parameters.
     for(const auto &param : head.get_params()) {
       Reference arg;
@@ -85,6 +86,9 @@ void Executive_context::initialize_for_function(Global_context &global, const Fu
     if(args.empty() && zvarg_opt) {
       do_set_constant(this->m_varg, D_function(*zvarg_opt));
     } else {
+      for(auto it = args.mut_begin(); it != args.mut_end(); ++it) {
+        it->convert_to_constant();
+      }
       do_set_constant(this->m_varg, D_function(Variadic_arguer(head.get_location(), std::move(args))));
     }
   }
@@ -12,7 +12,9 @@
 #include "rocket/preprocessor_utilities.h"
 #include "rocket/cow_string.hpp"
 #include "rocket/cow_vector.hpp"
+#include "rocket/cow_rrbvector.hpp"
 #include "rocket/cow_hashmap.hpp"
+#include "rocket/cow_hashtrie.hpp"
 
 namespace Asteria {
 
@@ -41,10 +43,14 @@ template<typename ElementT, Size sizeT>
   using Array = std::array<ElementT, sizeT>;
 template<typename ElementT>
   using Vector = rocket::cow_vector<ElementT>;
+template<typename ElementT>
+  using Persistent_vector = rocket::cow_rrbvector<ElementT>;
 template<typename FirstT, typename SecondT>
   using Bivector = rocket::cow_vector<std::pair<FirstT, SecondT>>;
 template<typename ElementT>
   using Dictionary = rocket::cow_hashmap<String, ElementT, String::hash, String::equal_to>;
+template<typename ElementT>
+  using Persistent_dictionary = rocket::cow_hashtrie<String, ElementT, String::hash, String::equal_to>;
 
 // General Utilities
 class Formatter;
@@ -68,6 +74,9 @@ class Single_source_file;
 
 // Runtime Objects
 class Value;
+class Value_array;
+class Value_object;
+class Value_string;
 class Abstract_opaque;
 class Shared_opaque_wrapper;
 class Abstract_function;
@@ -77,8 +86,12 @@ class Reference_modifier;
 class Reference;
 class Reference_stack;
 class Variable;
-class Variable_hashset;
+class Variable_list;
+class Variable_pool;
+class Variable_deleter;
 class Abstract_variable_callback;
+struct Collection_statistics;
+class Abstract_collection_callback;
 class Collector;
 class Abstract_context;
 class Analytic_context;
@@ -93,11 +106,11 @@ using D_null      = Nullptr;
 using D_boolean   = Boolean;
 using D_integer   = Sint64;
 using D_real      = Float64;
-using D_string    = String;
+using D_string    = Value_string;
 using D_opaque    = Shared_opaque_wrapper;
 using D_function  = Shared_function_wrapper;
-using D_array     = Vector<Value>;
-using D_object    = Dictionary<Value>;
+using D_array     = Value_array;
+using D_object    = Value_object;
 
 }
 
@@ -10,17 +10,100 @@ namespace Asteria {
 
 Global_collector::~Global_collector()
   {
+    // Variables of any generation may point to any collector, so detach all of them before any collector is destroyed.
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->detach_variables();
+    }
   }
 
 rocket::refcounted_ptr<Variable> Global_collector::create_tracked_variable()
   {
-    auto var = rocket::make_refcounted<Variable>();
+    auto var = this->m_pool->create_variable();
     this->m_gen_zero.track_variable(var);
     return var;
   }
 
+const Collector & Global_collector::do_get_collector(unsigned gen) const
+  {
+    switch(gen) {
+      case 0: {
+        return this->m_gen_zero;
+      }
+      case 1: {
+        return this->m_gen_one;
+      }
+      case 2: {
+        return this->m_gen_two;
+      }
+      default: {
+        ASTERIA_THROW_RUNTIME_ERROR("The generation `", gen, "` does not exist.");
+      }
+    }
+  }
+Collector & Global_collector::do_get_collector(unsigned gen)
+  {
+    return const_cast<Collector &>(static_cast<const Global_collector *>(this)->do_get_collector(gen));
+  }
+
+void Global_collector::do_finish_collection()
+  {
+    // At most one collection may be in progress at a time.
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->finish_collection();
+    }
+  }
+
+void Global_collector::set_thresholds(unsigned gen, Size threshold, Size byte_threshold)
+  {
+    this->do_get_collector(gen).set_thresholds(threshold, byte_threshold);
+  }
+
+void Global_collector::set_adaptive(bool adaptive)
+  {
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->set_adaptive(adaptive);
+    }
+  }
+
+Collection_statistics Global_collector::get_statistics(unsigned gen) const
+  {
+    return this->do_get_collector(gen).get_statistics();
+  }
+
+void Global_collector::set_callback(const Abstract_collection_callback *callback_opt)
+  {
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->set_callback_opt(callback_opt);
+    }
+  }
+
+void Global_collector::set_candidate_threshold(Size threshold)
+  {
+    // References from buffered variables may have been counted by the collection in progress.
+    this->do_finish_collection();
+    this->m_gen_zero.set_candidate_threshold(threshold);
+  }
+
+void Global_collector::set_step_limits(Size work_limit, Uint64 time_limit)
+  {
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->set_step_limits(work_limit, time_limit);
+    }
+    if(work_limit || time_limit) {
+      return;
+    }
+    // Collections are no longer incremental, so the one in progress must not be left behind.
+    this->do_finish_collection();
+  }
+
+void Global_collector::set_concurrent(bool concurrent)
+  {
+    this->m_gen_two.set_concurrent(concurrent);
+  }
+
 void Global_collector::perform_garbage_collection(unsigned gen_limit)
   {
+    this->do_finish_collection();
     auto qcoll = &(this->m_gen_zero);
     unsigned gen_cur = 0;
     do {
@@ -38,4 +121,15 @@ void Global_collector::perform_garbage_collection(unsigned gen_limit)
     } while(true);
   }
 
+void Global_collector::wipe_out_variables() noexcept
+  {
+    // A collection of one generation may examine variables of others, so abandon it before wiping out anything.
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->abort_collection();
+    }
+    for(auto qcoll = &(this->m_gen_zero); qcoll; qcoll = qcoll->get_tied_collector_opt()) {
+      qcoll->wipe_out_variables();
+    }
+  }
+
 }
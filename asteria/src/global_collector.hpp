@@ -6,21 +6,24 @@
 
 #include "fwd.hpp"
 #include "collector.hpp"
+#include "variable_pool.hpp"
 
 namespace Asteria {
 
 class Global_collector : public rocket::refcounted_base<Global_collector>
   {
   private:
+    rocket::refcounted_ptr<Variable_pool> m_pool;
     Collector m_gen_two;
     Collector m_gen_one;
     Collector m_gen_zero;
 
   public:
-    Global_collector() noexcept
-      : m_gen_two(nullptr, 15),
-        m_gen_one(&(this->m_gen_two), 50),
-        m_gen_zero(&(this->m_gen_one), 400)
+    Global_collector()
+      : m_pool(rocket::make_refcounted<Variable_pool>()),
+        m_gen_two(2, nullptr, 15, 0x400000),
+        m_gen_one(1, &(this->m_gen_two), 50, 0x100000),
+        m_gen_zero(0, &(this->m_gen_one), 400, 0x40000)
       {
       }
     ~Global_collector();
@@ -30,9 +33,28 @@ class Global_collector : public rocket::refcounted_base<Global_collector>
     Global_collector & operator=(const Global_collector &)
       = delete;
 
+  private:
+    const Collector & do_get_collector(unsigned gen) const;
+    Collector & do_get_collector(unsigned gen);
+    void do_finish_collection();
+
   public:
     rocket::refcounted_ptr<Variable> create_tracked_variable();
+    // See `Collector::set_thresholds()` and `Collector::set_adaptive()`.
+    void set_thresholds(unsigned gen, Size threshold, Size byte_threshold);
+    void set_adaptive(bool adaptive);
+    // See `Collector::get_statistics()` and `Collector::set_callback_opt()`.
+    Collection_statistics get_statistics(unsigned gen) const;
+    void set_callback(const Abstract_collection_callback *callback_opt);
+    // See `Collector::set_candidate_threshold()`. Variables are buffered by the youngest generation.
+    void set_candidate_threshold(Size threshold);
+    // If either limit is non-zero, garbage collection is performed incrementally. See `Collector::set_step_limits()`.
+    void set_step_limits(Size work_limit, Uint64 time_limit);
+    // If this is set, the oldest generation is collected concurrently. See `Collector::set_concurrent()`.
+    void set_concurrent(bool concurrent);
     void perform_garbage_collection(unsigned gen_limit);
+    // See `Collector::wipe_out_variables()`.
+    void wipe_out_variables() noexcept;
   };
 
 }
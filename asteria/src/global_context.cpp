@@ -10,7 +10,7 @@
 namespace Asteria {
 
 Global_context::Global_context()
-  : m_coll(rocket::make_refcounted<Global_collector>())
+  : m_coll(rocket::make_refcounted<Global_collector>()), m_fast_teardown(false)
   {
     ASTERIA_DEBUG_LOG("`Global_context` constructor: ", static_cast<void *>(this));
   }
@@ -18,6 +18,11 @@ Global_context::Global_context()
 Global_context::~Global_context()
   {
     ASTERIA_DEBUG_LOG("`Global_context` destructor: ", static_cast<void *>(this));
+    if(this->m_fast_teardown) {
+      this->do_clear_named_references();
+      this->m_coll->wipe_out_variables();
+      return;
+    }
     // Perform the final garbage collection.
     try {
       this->do_clear_named_references();
@@ -41,6 +46,41 @@ rocket::refcounted_ptr<Variable> Global_context::create_tracked_variable()
     return this->m_coll->create_tracked_variable();
   }
 
+void Global_context::set_garbage_collection_thresholds(unsigned gen, Size threshold, Size byte_threshold)
+  {
+    return this->m_coll->set_thresholds(gen, threshold, byte_threshold);
+  }
+
+void Global_context::set_adaptive_garbage_collection(bool adaptive)
+  {
+    return this->m_coll->set_adaptive(adaptive);
+  }
+
+Collection_statistics Global_context::get_garbage_collection_statistics(unsigned gen) const
+  {
+    return this->m_coll->get_statistics(gen);
+  }
+
+void Global_context::set_garbage_collection_callback(const Abstract_collection_callback *callback_opt)
+  {
+    return this->m_coll->set_callback(callback_opt);
+  }
+
+void Global_context::set_candidate_garbage_collection(Size threshold)
+  {
+    return this->m_coll->set_candidate_threshold(threshold);
+  }
+
+void Global_context::set_garbage_collection_step_limits(Size work_limit, Uint64 time_limit)
+  {
+    return this->m_coll->set_step_limits(work_limit, time_limit);
+  }
+
+void Global_context::set_concurrent_garbage_collection(bool concurrent)
+  {
+    return this->m_coll->set_concurrent(concurrent);
+  }
+
 void Global_context::perform_garbage_collection(unsigned gen_limit)
   {
     return this->m_coll->perform_garbage_collection(gen_limit);
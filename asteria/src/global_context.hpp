@@ -6,6 +6,7 @@
 
 #include "fwd.hpp"
 #include "abstract_context.hpp"
+#include "collection_statistics.hpp"
 #include "rocket/refcounted_ptr.hpp"
 
 namespace Asteria {
@@ -14,6 +15,7 @@ class Global_context : public Abstract_context
   {
   private:
     rocket::refcounted_ptr<Global_collector> m_coll;
+    bool m_fast_teardown;
 
   public:
     Global_context();
@@ -29,7 +31,48 @@ class Global_context : public Abstract_context
     const Abstract_context * get_parent_opt() const noexcept override;
 
     rocket::refcounted_ptr<Variable> create_tracked_variable();
+    // Garbage collection of generation `gen`, which shall be 0, 1 or 2, is triggered when the number of variables, or
+    // the estimated number of bytes of storage, that the generation has received since its last collection exceeds
+    // `threshold` or `byte_threshold` respectively. A byte threshold of zero means no limit.
+    void set_garbage_collection_thresholds(unsigned gen, Size threshold, Size byte_threshold);
+    // If this is set, thresholds are adjusted after each collection. If most variables survive it, the thresholds are
+    // increased, up to sixteen times the values above. If few variables survive it, they are decreased, down to a
+    // quarter of the values above. This is not set by default.
+    void set_adaptive_garbage_collection(bool adaptive);
+    // This function returns statistics of all garbage collections of generation `gen` that have finished. Collecting
+    // them costs a few additions per variable examined and two clock readings per step, so they are always enabled.
+    Collection_statistics get_garbage_collection_statistics(unsigned gen) const;
+    // The callback is invoked after each garbage collection of any generation finishes. It is not owned by this
+    // context, so it shall outlive this context, or be reset to null before it is destroyed.
+    void set_garbage_collection_callback(const Abstract_collection_callback *callback_opt);
+    // If `threshold` is non-zero, variables that are created afterwards are buffered as possible roots of cycles when
+    // references to them are dropped, and generations are no longer collected automatically. Instead, when more than
+    // `threshold` variables have been buffered, only variables that are reachable from them are examined, and those
+    // that are unreachable are wiped out. This suits scripts that create few cycles but keep many variables alive.
+    // Statistics of these collections are reported as generation 0. If `threshold` is zero, which is the default,
+    // this is disabled.
+    void set_candidate_garbage_collection(Size threshold);
+    // Garbage collection is performed in steps, each of which processes at most `work_limit` variables and takes at
+    // most about `time_limit` microseconds. A limit of zero means no limit. If both limits are zero, which is the
+    // default, garbage collection is not incremental.
+    void set_garbage_collection_step_limits(Size work_limit, Uint64 time_limit);
+    // If this is set, reachability of variables in the oldest generation is analyzed on a helper thread while the
+    // script continues. Unreachable variables are wiped out later by the thread that performs garbage collection.
+    void set_concurrent_garbage_collection(bool concurrent);
     void perform_garbage_collection(unsigned gen_limit);
+
+    bool is_fast_teardown() const noexcept
+      {
+        return this->m_fast_teardown;
+      }
+    // If this is set, when this context is destroyed, values of all variables that have been created by it are cleared
+    // in a linear pass, rather than by a full garbage collection. Variables that are still referenced elsewhere will
+    // be left holding `null`, so this should only be set if no references obtained from this context outlive it.
+    // This is not set by default.
+    void set_fast_teardown(bool fast_teardown) noexcept
+      {
+        this->m_fast_teardown = fast_teardown;
+      }
   };
 
 }
@@ -566,17 +566,30 @@ Parser::~Parser()
   bool do_accept_postfix_subscript(Vector<Xpnode> &nodes_out, Token_stream &tstrm_io)
     {
       // postfix-subscript ::=
-      //   "[" expression "]"
+      //   "[" expression ( ":" expression-opt | "" ) "]"
       if(!do_match_punctuator(tstrm_io, Token::punctuator_bracket_op)) {
         return false;
       }
       if(!do_accept_expression(nodes_out, tstrm_io)) {
         throw do_make_parser_error(tstrm_io, Parser_error::code_expression_expected);
       }
+      if(do_match_punctuator(tstrm_io, Token::punctuator_colon)) {
+        // This is a slice, whose length is optional.
+        if(!do_accept_expression(nodes_out, tstrm_io)) {
+          Xpnode::S_literal node_c = { D_null() };
+          nodes_out.emplace_back(std::move(node_c));
+        }
+        if(!do_match_punctuator(tstrm_io, Token::punctuator_bracket_cl)) {
+          throw do_make_parser_error(tstrm_io, Parser_error::code_close_bracket_expected);
+        }
+        Xpnode::S_operator_rpn node_c = { Xpnode::xop_postfix_slice, false };
+        nodes_out.emplace_back(std::move(node_c));
+        return true;
+      }
       if(!do_match_punctuator(tstrm_io, Token::punctuator_bracket_cl)) {
         throw do_make_parser_error(tstrm_io, Parser_error::code_close_bracket_expected);
       }
-      Xpnode::S_subscript node_c = { String() };
+      Xpnode::S_subscript node_c = { String(), 0, rocket::make_refcounted<Reference::S_site_cache>() };
       nodes_out.emplace_back(std::move(node_c));
       return true;
     }
@@ -592,7 +605,8 @@ Parser::~Parser()
       if(!do_accept_identifier(name, tstrm_io)) {
         throw do_make_parser_error(tstrm_io, Parser_error::code_identifier_expected);
       }
-      Xpnode::S_subscript node_c = { std::move(name) };
+      auto hash = String::hash()(name);
+      Xpnode::S_subscript node_c = { std::move(name), hash, rocket::make_refcounted<Reference::S_site_cache>() };
       nodes_out.emplace_back(std::move(node_c));
       return true;
     }
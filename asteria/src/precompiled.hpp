@@ -40,7 +40,9 @@
 #include "rocket/variant.hpp"
 #include "rocket/cow_string.hpp"
 #include "rocket/cow_vector.hpp"
+#include "rocket/cow_rrbvector.hpp"
 #include "rocket/cow_hashmap.hpp"
+#include "rocket/cow_hashtrie.hpp"
 #include "rocket/refcounted_ptr.hpp"
 
 namespace Asteria {
@@ -24,51 +24,218 @@ Reference::Reference(Reference &&) noexcept
 Reference & Reference::operator=(Reference &&) noexcept
   = default;
 
-Value Reference::read() const
+Value * Reference::do_get_cached_parent_opt() const noexcept
   {
+    const auto qparent = this->m_cache_parent;
+    if(!qparent) {
+      return nullptr;
+    }
+    // The parent is only cached if the root is a variable.
+    const auto &var = this->m_root.check<Reference_root::S_variable>().var;
+    if(var->get_stamp() != this->m_cache_stamp) {
+      // The value has been modified or copied since the parent was resolved.
+      this->m_cache_parent = nullptr;
+      return nullptr;
+    }
+    return qparent;
+  }
+
+bool Reference::do_check_site_path(const S_site_cache &site) const noexcept
+  {
+    // Compare modifiers other than the last one.
+    const auto begin = this->do_mods_begin();
+    const auto end = this->do_mods_end() - 1;
+    if(static_cast<Size>(end - begin) != site.path.size()) {
+      return false;
+    }
+    return std::equal(begin, end, site.path.begin(), [](const Reference_modifier &lhs, const Reference_modifier &rhs) { return lhs.is_same_as(rhs); });
+  }
+
+void Reference::do_store_parent_to_site() const
+  {
+    auto &site = *(this->m_site_opt);
+    site.parent = this->m_cache_parent;
+    site.stamp = this->m_cache_stamp;
+    if(!this->do_check_site_path(site)) {
+      site.path.assign(this->do_mods_begin(), this->do_mods_end() - 1);
+    }
+  }
+
+const Value & Reference::do_peek(Value &temp_out) const
+  {
+    const auto qparent = this->do_get_cached_parent_opt();
+    if(qparent) {
+      // Apply the last modifier to the cached parent.
+      const auto qcur = (this->do_mods_end() - 1)->apply_readonly_opt(*qparent, temp_out);
+      if(!qcur) {
+        temp_out = D_null();
+        return temp_out;
+      }
+      return *qcur;
+    }
     // Dereference the root.
-    auto cur = std::ref(this->m_root.dereference_readonly());
+    auto qcur = &(this->m_root.dereference_readonly());
     // Apply modifiers.
-    const auto end = this->m_mods.end();
-    for(auto it = this->m_mods.begin(); it != end; ++it) {
-      const auto qnext = it->apply_readonly_opt(cur);
-      if(!qnext) {
-        return { };
+    // N.B. Unboxed array elements cannot be modified further, so `temp_out` may be reused safely.
+    const auto end = this->do_mods_end();
+    for(auto it = this->do_mods_begin(); it != end; ++it) {
+      qcur = it->apply_readonly_opt(*qcur, temp_out);
+      if(!qcur) {
+        temp_out = D_null();
+        return temp_out;
       }
-      cur = std::ref(*qnext);
     }
     // Return the value found.
-    return cur;
+    return *qcur;
+  }
+
+const Value & Reference::peek(Value &temp_out) const
+  {
+    const auto &value = this->do_peek(temp_out);
+    // A copy of an array or object shares storage with it, which must not be modified via cached pointers any more.
+    // Other values are never modified in place via cached pointers.
+    if(rocket::is_any_of(value.type(), { Value::type_array, Value::type_object })) {
+      const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+      if(qvar) {
+        qvar->var->bump_stamp();
+      }
+    }
+#ifdef ROCKET_DEBUG
+    this->m_peek_stamp = this->do_get_root_stamp();
+#endif
+    return value;
+  }
+
+Value Reference::read() const
+  {
+    Value temp;
+    Value value = this->do_peek(temp);
+    const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+    if(qvar) {
+      // The copy shares storage with the variable, which must not be modified via cached pointers any more.
+      qvar->var->bump_stamp();
+    }
+    return value;
   }
 
-Value & Reference::write(Value value) const
+void Reference::write(Value value) const
   {
+    const auto qparent = this->do_get_cached_parent_opt();
+    if(qparent) {
+      // Invalidate pointers cached by other references, as the parent may be restructured.
+      const auto &var = this->m_root.check<Reference_root::S_variable>().var;
+      var->bump_stamp();
+      // Set the new value via the last modifier. The parent itself is not moved, so it remains valid.
+      (this->do_mods_end() - 1)->apply_store(*qparent, std::move(value));
+      var->notify_modified();
+      this->m_cache_stamp = var->get_stamp();
+      if(this->m_site_opt) {
+        this->do_store_parent_to_site();
+      }
+      return;
+    }
     // Dereference the root.
     auto cur = std::ref(this->m_root.dereference_mutable());
-    // Apply modifiers.
-    const auto end = this->m_mods.end();
-    for(auto it = this->m_mods.begin(); it != end; ++it) {
+    const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+    if(this->do_mods_begin() == this->do_mods_end()) {
+      // Set the new value.
+      cur.get() = std::move(value);
+      if(qvar) {
+        qvar->var->notify_modified();
+      }
+      return;
+    }
+    // Apply modifiers other than the last one.
+    // Members of opaque values may be moved without changing the stamp, so they cannot be cached.
+    bool cacheable = true;
+    const auto end = this->do_mods_end() - 1;
+    for(auto it = this->do_mods_begin(); it != end; ++it) {
+      cacheable &= (cur.get().type() != Value::type_opaque);
       const auto qnext = it->apply_mutable_opt(cur, true, nullptr);
       if(!qnext) {
         ROCKET_ASSERT(false);
       }
       cur = std::ref(*qnext);
     }
-    // Set the new value.
-    cur.get() = std::move(value);
-    return cur;
+    // Set the new value via the last modifier.
+    end->apply_store(cur, std::move(value));
+    if(qvar) {
+      qvar->var->notify_modified();
+    }
+    // Cache the parent if possible.
+    if(qvar && cacheable) {
+      this->m_cache_parent = &(cur.get());
+      this->m_cache_stamp = qvar->var->get_stamp();
+      if(this->m_site_opt) {
+        this->do_store_parent_to_site();
+      }
+    }
+  }
+
+Value * Reference::open_opt() const
+  {
+    // Dereference the root.
+    const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+    if(!qvar || qvar->var->is_immutable()) {
+      return nullptr;
+    }
+    const auto qparent = this->do_get_cached_parent_opt();
+    // Invalidate pointers cached by other references, as containers may be unshared or modified in place.
+    qvar->var->bump_stamp();
+    Value *qcur;
+    if(qparent) {
+      // Apply the last modifier to the cached parent. The parent itself is not moved, so it remains valid.
+      qcur = (this->do_mods_end() - 1)->apply_open_opt(*qparent);
+      this->m_cache_stamp = qvar->var->get_stamp();
+      if(this->m_site_opt) {
+        this->do_store_parent_to_site();
+      }
+    } else if(this->do_mods_begin() == this->do_mods_end()) {
+      qcur = &(qvar->var->get_value());
+    } else {
+      qcur = &(qvar->var->get_value());
+      // Apply modifiers other than the last one.
+      // Members of opaque values may be moved without changing the stamp, so they cannot be cached.
+      bool cacheable = true;
+      const auto end = this->do_mods_end() - 1;
+      for(auto it = this->do_mods_begin(); it != end; ++it) {
+        cacheable &= (qcur->type() != Value::type_opaque);
+        qcur = it->apply_open_opt(*qcur);
+        if(!qcur) {
+          return nullptr;
+        }
+      }
+      // Cache the parent if possible, even if the last modifier fails, as the caller is likely to fall back to `peek()`
+      // and `write()`.
+      if(cacheable) {
+        this->m_cache_parent = qcur;
+        this->m_cache_stamp = qvar->var->get_stamp();
+        if(this->m_site_opt) {
+          this->do_store_parent_to_site();
+        }
+      }
+      qcur = end->apply_open_opt(*qcur);
+    }
+    if(!qcur) {
+      return nullptr;
+    }
+    // Scalars and strings are modified without changing their types, so they never gain references to variables.
+    if(!rocket::is_any_of(qcur->type(), { Value::type_boolean, Value::type_integer, Value::type_real, Value::type_string })) {
+      qvar->var->prepare_modification();
+    }
+    return qcur;
   }
 
 Value Reference::unset() const
   {
-    if(this->m_mods.empty()) {
+    if(this->do_mods_begin() == this->do_mods_end()) {
       ASTERIA_THROW_RUNTIME_ERROR("Only array elements or object members may be `unset`.");
     }
     // Dereference the root.
     auto cur = std::ref(this->m_root.dereference_mutable());
     // Apply modifiers.
-    const auto end = this->m_mods.end() - 1;
-    for(auto it = this->m_mods.begin(); it != end; ++it) {
+    const auto end = this->do_mods_end() - 1;
+    for(auto it = this->do_mods_begin(); it != end; ++it) {
       const auto qnext = it->apply_mutable_opt(cur, false, nullptr);
       if(!qnext) {
         return { };
@@ -84,26 +251,79 @@ Value Reference::unset() const
 Reference & Reference::zoom_in(Reference_modifier mod)
   {
     // Append a modifier.
-    this->m_mods.emplace_back(std::move(mod));
+    if(!this->m_mods_ext.empty()) {
+      this->m_mods_ext.emplace_back(std::move(mod));
+    } else if(this->m_mods.size() < this->m_mods.capacity()) {
+      this->m_mods.emplace_back(std::move(mod));
+    } else {
+      // The inline buffer is full. Move all modifiers out of it.
+      this->m_mods_ext.reserve(this->m_mods.size() + 1);
+      for(auto &elem : this->m_mods) {
+        this->m_mods_ext.emplace_back(std::move(elem));
+      }
+      this->m_mods_ext.emplace_back(std::move(mod));
+      this->m_mods.clear();
+    }
+    this->m_cache_parent = nullptr;
+    this->m_site_opt = nullptr;
     return *this;
   }
 
 Reference & Reference::zoom_out()
   {
-    if(this->m_mods.empty()) {
+    if(this->do_mods_begin() == this->do_mods_end()) {
       // If there is no modifier, set `*this` to a null reference.
       Reference_root::S_constant ref_c = { D_null() };
       *this = std::move(ref_c);
       return *this;
     }
     // Drop the last modifier.
-    this->m_mods.pop_back();
+    // N.B. If `m_mods_ext` is in use, it had more modifiers than the inline buffer can hold, so it will not become empty.
+    if(!this->m_mods_ext.empty()) {
+      this->m_mods_ext.pop_back();
+    } else {
+      this->m_mods.pop_back();
+    }
+    this->m_cache_parent = nullptr;
+    this->m_site_opt = nullptr;
+    return *this;
+  }
+
+Reference & Reference::share_site_cache(rocket::refcounted_ptr<S_site_cache> site)
+  {
+    ROCKET_ASSERT(this->do_mods_begin() != this->do_mods_end());
+    this->m_site_opt = std::move(site);
+    // The parent is only cached if the root is a variable.
+    const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+    if(!this->m_site_opt || !qvar) {
+      return *this;
+    }
+    // As stamps are never reused, a parent with the current stamp of the variable has been resolved from it.
+    const auto &site_ref = *(this->m_site_opt);
+    if(!site_ref.parent || (site_ref.stamp != qvar->var->get_stamp()) || !this->do_check_site_path(site_ref)) {
+      return *this;
+    }
+    this->m_cache_parent = site_ref.parent;
+    this->m_cache_stamp = site_ref.stamp;
+    return *this;
+  }
+
+Reference & Reference::convert_to_constant()
+  {
+    const auto qref = this->m_root.opt<Reference_root::S_constant_ref>();
+    if(!qref) {
+      return *this;
+    }
+    // Copy the constant. Modifiers are retained.
+    Reference_root::S_constant ref_c = { *(qref->src) };
+    this->m_root = std::move(ref_c);
     return *this;
   }
 
 Reference & Reference::convert_to_temporary()
   {
-    if(this->m_root.index() == Reference_root::index_temporary) {
+    // N.B. A temporary that is followed by modifiers is converted, too, as the rest of it may keep variables alive.
+    if((this->m_root.index() == Reference_root::index_temporary) && (this->do_mods_begin() == this->do_mods_end())) {
       return *this;
     }
     // Create an rvalue.
@@ -7,24 +7,56 @@
 #include "fwd.hpp"
 #include "reference_root.hpp"
 #include "reference_modifier.hpp"
+#include "rocket/static_vector.hpp"
+#include "rocket/refcounted_ptr.hpp"
 
 namespace Asteria {
 
 class Reference
   {
+  public:
+    // This is shared by all references that are created by the same subscript expression, so a parent that has been
+    // resolved through one of them can be reused by the next one. The parent is valid as long as the stamp of the root
+    // variable equals `stamp`, which also identifies the variable, and the modifiers other than the last one equal
+    // `path`.
+    struct S_site_cache : rocket::refcounted_base<S_site_cache>
+      {
+        Value *parent;
+        Uint64 stamp;
+        Vector<Reference_modifier> path;
+
+        S_site_cache() noexcept
+          : parent(nullptr), stamp(0), path()
+          {
+          }
+      };
+
   private:
     Reference_root m_root;
-    Vector<Reference_modifier> m_mods;
+    // Most paths are short, so the first few modifiers are stored inline.
+    // If there are more, all modifiers are moved into `m_mods_ext`, which is non-empty if and only if it is in use.
+    rocket::static_vector<Reference_modifier, 3> m_mods;
+    Vector<Reference_modifier> m_mods_ext;
+    // If the root is a variable, this caches the parent of the value referenced, which is resolved by `write()`.
+    // It is valid as long as the stamp of the variable equals `m_cache_stamp`.
+    mutable Value *m_cache_parent;
+    mutable Uint64 m_cache_stamp;
+    // If this is non-null, the parent resolved by `write()` is stored here, too.
+    rocket::refcounted_ptr<S_site_cache> m_site_opt;
+#ifdef ROCKET_DEBUG
+    // This is the stamp of the root variable when `peek()` was called last time. See `check_peeked()`.
+    mutable Uint64 m_peek_stamp = 0;
+#endif
 
   public:
     Reference() noexcept
-      : m_root(), m_mods()
+      : m_root(), m_mods(), m_mods_ext(), m_cache_parent(nullptr), m_cache_stamp(0), m_site_opt()
       {
       }
     // This constructor does not accept lvalues.
     template<typename XrootT, typename std::enable_if<(Reference_root::Variant::index_of<XrootT>::value || true)>::type * = nullptr>
       Reference(XrootT &&xroot)
-      : m_root(std::forward<XrootT>(xroot)), m_mods()
+      : m_root(std::forward<XrootT>(xroot)), m_mods(), m_mods_ext(), m_cache_parent(nullptr), m_cache_stamp(0), m_site_opt()
       {
       }
     // This assignment operator does not accept lvalues.
@@ -33,6 +65,9 @@ class Reference
       {
         this->m_root = std::forward<XrootT>(xroot);
         this->m_mods.clear();
+        this->m_mods_ext.clear();
+        this->m_cache_parent = nullptr;
+        this->m_site_opt = nullptr;
         return *this;
       }
     ~Reference();
@@ -42,19 +77,66 @@ class Reference
     Reference(Reference &&) noexcept;
     Reference & operator=(Reference &&) noexcept;
 
+  private:
+    const Reference_modifier * do_mods_begin() const noexcept
+      {
+        return this->m_mods_ext.empty() ? this->m_mods.data() : this->m_mods_ext.data();
+      }
+    const Reference_modifier * do_mods_end() const noexcept
+      {
+        return this->m_mods_ext.empty() ? (this->m_mods.data() + this->m_mods.size()) : (this->m_mods_ext.data() + this->m_mods_ext.size());
+      }
+    Uint64 do_get_root_stamp() const noexcept
+      {
+        const auto qvar = this->m_root.opt<Reference_root::S_variable>();
+        return qvar ? qvar->var->get_stamp() : 0;
+      }
+    Value * do_get_cached_parent_opt() const noexcept;
+    const Value & do_peek(Value &temp_out) const;
+    bool do_check_site_path(const S_site_cache &site) const noexcept;
+    void do_store_parent_to_site() const;
+
   public:
     bool is_constant() const noexcept
       {
-        return this->m_root.index() == Reference_root::index_constant;
+        return rocket::is_any_of(this->m_root.index(), { Reference_root::index_constant, Reference_root::index_constant_ref });
       }
 
+    // Get a reference to the value referenced without copying it.
+    // If the value does not exist, or is an element of an unboxed array, it is stored into `temp_out`, to which the
+    // result refers.
+    // N.B. The result is invalidated by any modification of the value, including one through another reference. Copy it
+    // with `read()` if the value has to outlive such a modification.
+    // If the result is an array or object, the stamp of the root variable is changed, as a copy of it shares storage with
+    // the variable.
+    const Value & peek(Value &temp_out) const;
+    // In debug builds, this function checks that the root variable has not been modified since the last call to
+    // `peek()`, so its result may still be used. In release builds, it does nothing.
+    void check_peeked() const noexcept
+      {
+#ifdef ROCKET_DEBUG
+        ROCKET_ASSERT_MSG(this->do_get_root_stamp() == this->m_peek_stamp, "The result of `peek()` has been invalidated.");
+#endif
+      }
     Value read() const;
-    Value & write(Value value) const;
+    void write(Value value) const;
+    // Get a pointer to the value referenced so it can be modified in place.
+    // This function returns a null pointer if the value is not stored in a mutable variable, does not exist, or is an
+    // element of an unboxed array. The caller shall fall back to `read()` and `write()` in these cases.
+    // N.B. If the value is a boolean, integer, real or string, the caller shall not change its type via the result.
+    Value * open_opt() const;
     Value unset() const;
 
     Reference & zoom_in(Reference_modifier mod);
     Reference & zoom_out();
+    // Share the parent of the value referenced with other references that are created by the same subscript expression.
+    // This function shall be called after the last modifier is appended. If `site` holds the parent of the value
+    // referenced, it will not be resolved again. `site` may be null, in which case nothing is shared.
+    Reference & share_site_cache(rocket::refcounted_ptr<S_site_cache> site);
 
+    // If this reference refers to a constant in the AST, replace its root with a copy of the constant.
+    // This function shall be called before a reference is stored somewhere it may outlive the AST.
+    Reference & convert_to_constant();
     Reference & convert_to_temporary();
     Reference & convert_to_variable(Global_context &global);
 
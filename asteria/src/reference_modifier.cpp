@@ -12,7 +12,28 @@ Reference_modifier::~Reference_modifier()
   {
   }
 
-const Value * Reference_modifier::apply_readonly_opt(const Value &parent) const
+bool Reference_modifier::is_same_as(const Reference_modifier &other) const noexcept
+  {
+    if(this->m_stor.index() != other.m_stor.index()) {
+      return false;
+    }
+    switch(Index(this->m_stor.index())) {
+      case index_array_index: {
+        const auto &alt = this->m_stor.as<S_array_index>();
+        return alt.index == other.m_stor.as<S_array_index>().index;
+      }
+      case index_object_key: {
+        const auto &alt = this->m_stor.as<S_object_key>();
+        const auto &other_alt = other.m_stor.as<S_object_key>();
+        return (alt.hash == other_alt.hash) && (alt.key == other_alt.key);
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown reference modifier type enumeration `", this->m_stor.index(), "` has been encountered.");
+      }
+    }
+  }
+
+const Value * Reference_modifier::apply_readonly_opt(const Value &parent, Value &unboxed_out) const
   {
     switch(Index(this->m_stor.index())) {
       case index_array_index: {
@@ -29,7 +50,12 @@ const Value * Reference_modifier::apply_readonly_opt(const Value &parent) const
               ASTERIA_DEBUG_LOG("Array index is out of range: index = ", alt.index, ", size = ", arr.size());
               return nullptr;
             }
-            return &(arr.at(static_cast<Size>(rindex)));
+            const auto qelems = arr.opt<Persistent_vector<Value>>();
+            if(!qelems) {
+              unboxed_out = arr.at(static_cast<Size>(rindex));
+              return &unboxed_out;
+            }
+            return &(qelems->at(static_cast<Size>(rindex)));
           }
           default: {
             ASTERIA_THROW_RUNTIME_ERROR("Index `", alt.index, "` cannot be applied to `", parent, "`.");
@@ -44,7 +70,7 @@ const Value * Reference_modifier::apply_readonly_opt(const Value &parent) const
           }
           case Value::type_object: {
             const auto &obj = parent.check<D_object>();
-            auto rit = obj.find(alt.key);
+            auto rit = obj.find(alt.key, alt.hash);
             if(rit == obj.end()) {
               ASTERIA_DEBUG_LOG("Object key was not found: key = ", alt.key, ", parent = ", parent);
               return nullptr;
@@ -97,7 +123,7 @@ Value * Reference_modifier::apply_mutable_opt(Value &parent, bool create_new, Va
                 ASTERIA_THROW_RUNTIME_ERROR("Extending the array of size `", arr.size(), "` by `", rsize_add, "` would exceed system resource limits.");
               }
               if(bfill != 0) {
-                arr.insert(arr.begin(), static_cast<Size>(bfill));
+                arr.prepend(static_cast<Size>(bfill));
                 rindex += bfill;
               }
               if(efill != 0) {
@@ -105,8 +131,7 @@ Value * Reference_modifier::apply_mutable_opt(Value &parent, bool create_new, Va
               }
             }
             if(erased_out_opt) {
-              *erased_out_opt = std::move(arr.mut(static_cast<Size>(rindex)));
-              arr.erase(arr.begin() + static_cast<Diff>(rindex));
+              *erased_out_opt = arr.erase(static_cast<Size>(rindex));
               return erased_out_opt;
             }
             return &(arr.mut(static_cast<Size>(rindex)));
@@ -127,7 +152,7 @@ Value * Reference_modifier::apply_mutable_opt(Value &parent, bool create_new, Va
             // Fallthrough.
           case Value::type_object:
             auto &obj = parent.check<D_object>();
-            auto rit = create_new ? obj.try_emplace(alt.key).first : obj.find_mut(alt.key);
+            auto rit = create_new ? obj.try_emplace_with_hash(alt.key, alt.hash).first : obj.find_mut(alt.key, alt.hash);
             if(rit == obj.end()) {
               ASTERIA_DEBUG_LOG("Object key was not found: key = ", alt.key, ", parent = ", parent);
               return nullptr;
@@ -164,4 +189,57 @@ Value * Reference_modifier::apply_mutable_opt(Value &parent, bool create_new, Va
     }
   }
 
+void Reference_modifier::apply_store(Value &parent, Value &&value) const
+  {
+    switch(Index(this->m_stor.index())) {
+      case index_array_index: {
+        const auto &alt = this->m_stor.as<S_array_index>();
+        const auto qarr = parent.opt<D_array>();
+        if(!qarr) {
+          break;
+        }
+        Uint64 bfill, efill;
+        auto rindex = wrap_index(bfill, efill, alt.index, qarr->size());
+        if(rindex < qarr->size()) {
+          // The array remains unboxed if `value` has the same type as its elements.
+          qarr->set(static_cast<Size>(rindex), std::move(value));
+          return;
+        }
+        if(rindex == qarr->size()) {
+          // Likewise.
+          qarr->push_back(std::move(value));
+          return;
+        }
+        break;
+      }
+      case index_object_key: {
+        const auto &alt = this->m_stor.as<S_object_key>();
+        const auto qobj = parent.opt<D_object>();
+        if(!qobj) {
+          break;
+        }
+        qobj->insert_or_assign_with_hash(alt.key, alt.hash, std::move(value));
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown reference modifier type enumeration `", this->m_stor.index(), "` has been encountered.");
+      }
+    }
+    const auto qnext = this->apply_mutable_opt(parent, true, nullptr);
+    ROCKET_ASSERT(qnext);
+    *qnext = std::move(value);
+  }
+
+Value * Reference_modifier::apply_open_opt(Value &parent) const
+  {
+    if(this->m_stor.index() == index_array_index) {
+      const auto qarr = parent.opt<D_array>();
+      if(qarr && (qarr->mode() != D_array::mode_generic)) {
+        // Unboxed elements cannot be referenced.
+        return nullptr;
+      }
+    }
+    return this->apply_mutable_opt(parent, false, nullptr);
+  }
+
 }
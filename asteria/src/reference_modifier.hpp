@@ -19,6 +19,18 @@ class Reference_modifier
     struct S_object_key
       {
         String key;
+        Size hash;  // This is always equal to `String::hash()(key)`.
+
+        explicit S_object_key(String xkey)
+          : key(std::move(xkey)), hash(String::hash()(this->key))
+          {
+          }
+        // This constructor takes a hash value that was computed beforehand, such as at parse time.
+        S_object_key(String xkey, Size xhash)
+          : key(std::move(xkey)), hash(xhash)
+          {
+            ROCKET_ASSERT(this->hash == String::hash()(this->key));
+          }
       };
 
     enum Index : Uint8
@@ -52,13 +64,24 @@ class Reference_modifier
     ~Reference_modifier();
 
   public:
-    const Value * apply_readonly_opt(const Value &parent) const;
+    // Two modifiers are the same if they designate the same element of any parent.
+    bool is_same_as(const Reference_modifier &other) const noexcept;
+
+    // If the element is stored unboxed, it is copied into `unboxed_out`, and this function returns `&unboxed_out`.
+    const Value * apply_readonly_opt(const Value &parent, Value &unboxed_out) const;
     // 1. If `create_new` is `true`, a new element is created if no one exists, and this function returns a pointer to
     //    it which is never null.
     // 2. If `erased_out_opt` is non-null, any existent element is removed, which is move-assigned to `*erased_out_opt`,
     //    and this function returns `erased_out_opt`.
     // 3. If no such element is found or created, this function returns a null pointer.
     Value * apply_mutable_opt(Value &parent, bool create_new, Value *erased_out_opt) const;
+    // This function is equivalent to `*apply_mutable_opt(parent, true, nullptr) = std::move(value)`, except that
+    // unboxed array elements are overwritten in place if possible, and existent elements are overwritten without making
+    // the container conservatively assume that it may contain variables.
+    void apply_store(Value &parent, Value &&value) const;
+    // This function is equivalent to `apply_mutable_opt(parent, false, nullptr)`, except that it returns a null pointer
+    // rather than converting an unboxed array to a generic one.
+    Value * apply_open_opt(Value &parent) const;
   };
 
 }
@@ -3,11 +3,37 @@
 
 #include "precompiled.hpp"
 #include "reference_root.hpp"
+#include "variable.hpp"
 #include "abstract_variable_callback.hpp"
 #include "utilities.hpp"
 
 namespace Asteria {
 
+Reference_root::S_variable & Reference_root::S_variable::operator=(const S_variable &other) noexcept
+  {
+    if(this->var) {
+      this->var->notify_released();
+    }
+    this->var = other.var;
+    return *this;
+  }
+
+Reference_root::S_variable & Reference_root::S_variable::operator=(S_variable &&other) noexcept
+  {
+    if(this->var) {
+      this->var->notify_released();
+    }
+    this->var = std::move(other.var);
+    return *this;
+  }
+
+Reference_root::S_variable::~S_variable()
+  {
+    if(this->var) {
+      this->var->notify_released();
+    }
+  }
+
 Reference_root::~Reference_root()
   {
   }
@@ -27,6 +53,10 @@ const Value & Reference_root::dereference_readonly() const
         const auto &alt = this->check<S_variable>();
         return alt.var->get_value();
       }
+      case index_constant_ref: {
+        const auto &alt = this->check<S_constant_ref>();
+        return *(alt.src);
+      }
       default: {
         ASTERIA_TERMINATE("An unknown reference root type enumeration `", this->index(), "` has been encountered.");
       }
@@ -49,8 +79,14 @@ Value & Reference_root::dereference_mutable() const
         if(alt.var->is_immutable()) {
           ASTERIA_THROW_RUNTIME_ERROR("The variable having value `", alt.var->get_value(), "` is immutable and cannot be modified.");
         }
+        // Invalidate pointers into the value that are cached elsewhere.
+        alt.var->bump_stamp();
         return alt.var->get_value();
       }
+      case index_constant_ref: {
+        const auto &alt = this->check<S_constant_ref>();
+        ASTERIA_THROW_RUNTIME_ERROR("The constant `", *(alt.src), "` cannot be modified.");
+      }
       default: {
         ASTERIA_TERMINATE("An unknown reference root type enumeration `", this->index(), "` has been encountered.");
       }
@@ -78,6 +114,11 @@ void Reference_root::enumerate_variables(const Abstract_variable_callback &callb
         }
         return;
       }
+      case index_constant_ref: {
+        const auto &alt = this->check<S_constant_ref>();
+        alt.src->enumerate_variables(callback);
+        return;
+      }
       default: {
         ASTERIA_TERMINATE("An unknown reference root type enumeration `", this->index(), "` has been encountered.");
       }
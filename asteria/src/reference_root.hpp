@@ -25,19 +25,32 @@ class Reference_root
     struct S_variable
       {
         rocket::refcounted_ptr<Variable> var;
+
+        // Dropping a reference to a variable may leave a cycle unreachable. See `Variable::notify_released()`.
+        S_variable(const S_variable &) = default;
+        S_variable & operator=(const S_variable &other) noexcept;
+        S_variable(S_variable &&) noexcept = default;
+        S_variable & operator=(S_variable &&other) noexcept;
+        ~S_variable();
+      };
+    struct S_constant_ref
+      {
+        const Value *src;  // This points to a constant in the AST, which shall outlive this reference.
       };
 
     enum Index : Uint8
       {
-        index_constant   = 0,
-        index_temporary  = 1,
-        index_variable   = 2,
+        index_constant       = 0,
+        index_temporary      = 1,
+        index_variable       = 2,
+        index_constant_ref   = 3,
       };
     using Variant = rocket::variant<
       ROCKET_CDR(
-        , S_constant   // 0,
-        , S_temporary  // 1,
-        , S_variable   // 2,
+        , S_constant      // 0,
+        , S_temporary     // 1,
+        , S_variable      // 2,
+        , S_constant_ref  // 3,
       )>;
 
   private:
@@ -80,6 +93,8 @@ class Reference_root
       }
 
     const Value & dereference_readonly() const;
+    // This function changes the stamp of the root variable. If the value is modified in a way that may make it able to
+    // form a cycle, `Variable::notify_modified()` shall be called afterwards.
     Value & dereference_mutable() const;
 
     void enumerate_variables(const Abstract_variable_callback &callback) const;
@@ -15,6 +15,9 @@
 #include <cstddef> // std::size_t, std::ptrdiff_t
 #include <cstring> // std::memset()
 #include <cstdint> // std::uint32_t
+#ifdef __SSE2__
+#  include <emmintrin.h> // _mm_loadu_si128(), _mm_cmpeq_epi8(), _mm_movemask_epi8()
+#endif
 #include "compatibility.h"
 #include "assert.hpp"
 #include "throw.hpp"
@@ -30,6 +33,8 @@
  * 5. There are no buckets. Bucket lookups and local iterators are not provided. The non-unique (`unordered_multimap`) equivalent cannot be implemented.
  * 6. The key and mapped types may be incomplete. The mapped type need be neither copy-assignable nor move-assignable.
  * 7. `erase()` may move elements around and invalidate iterators.
+ * 8. Each bucket has a tag byte, which is scanned before any key is compared. Tags are compared 16 at a time if SSE2 is available.
+ * 9. Small hashmaps store elements in-place and search keys linearly. They are converted to hash tables transparently when they grow.
  */
 
 namespace rocket {
@@ -107,49 +112,59 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
     struct handle_storage
     {
       using allocator_type   = allocatorT;
+      using value_type       = typename allocator_type::value_type;
       using handle_type      = value_handle<allocator_type>;
+      using pointer          = typename allocator_traits<allocator_type>::pointer;
       using size_type        = typename allocator_traits<allocator_type>::size_type;
 
+      // Each bucket consists of a handle and a tag byte. All tags are stored after all handles.
       static constexpr size_type min_nblk_for_nbkt(size_type nbkt) noexcept
         {
-          return (nbkt * sizeof(handle_type) + sizeof(handle_storage) - 1) / sizeof(handle_storage) + 1;
+          return (nbkt * (sizeof(handle_type) + 1) + sizeof(handle_storage) - 1) / sizeof(handle_storage) + 1;
         }
       static constexpr size_type max_nbkt_for_nblk(size_type nblk) noexcept
         {
-          return (nblk - 1) * sizeof(handle_storage) / sizeof(handle_type);
+          return (nblk - 1) * sizeof(handle_storage) / (sizeof(handle_type) + 1);
+        }
+      // In small mode, each bucket also has an inline slot for its element. All slots are stored after all tags.
+      static constexpr size_type min_nblk_for_nslot(size_type nslot) noexcept
+        {
+          return min_nblk_for_nbkt(nslot) + (nslot * sizeof(value_type) + sizeof(handle_storage) - 1) / sizeof(handle_storage);
         }
 
       atomic<long> nref;
       allocator_type alloc;
       size_type nblk;
+      size_type nbkt;
+      size_type nslot;
       size_type nelem;
       union { handle_type data[0]; };
 
-      handle_storage(const allocator_type &xalloc, size_type xnblk) noexcept
-        : alloc(xalloc), nblk(xnblk)
+      handle_storage(const allocator_type &xalloc, size_type xnblk, size_type xnslot) noexcept
+        : alloc(xalloc), nblk(xnblk), nbkt((xnslot != 0) ? xnslot : max_nbkt_for_nblk(xnblk)), nslot(xnslot)
         {
-          const auto nbkt = max_nbkt_for_nblk(this->nblk);
           // `allocator_type::pointer` need not be a trivial type.
           // The C++ standard requires that value-initialization of such an object shall not throw exceptions and shall result in a null pointer.
-          for(size_type i = 0; i < nbkt; ++i) {
+          for(size_type i = 0; i < this->nbkt; ++i) {
             noadl::construct_at(this->data + i);
           }
+          // Mark all buckets empty.
+          ::std::memset(this->tags(), 0, this->nbkt);
           this->nelem = 0;
           this->nref.store(1, ::std::memory_order_release);
         }
       ~handle_storage()
         {
-          const auto nbkt = max_nbkt_for_nblk(this->nblk);
-          for(size_type i = 0; i < nbkt; ++i) {
+          for(size_type i = 0; i < this->nbkt; ++i) {
             const auto eptr = this->data[i].set(nullptr);
             if(!eptr) {
                 continue;
             }
             allocator_traits<allocator_type>::destroy(this->alloc, noadl::unfancy(eptr));
-            allocator_traits<allocator_type>::deallocate(this->alloc, eptr, size_t(1));
+            this->deallocate_element(eptr);
           }
           // `allocator_type::pointer` need not be a trivial type.
-          for(size_type i = 0; i < nbkt; ++i) {
+          for(size_type i = 0; i < this->nbkt; ++i) {
             noadl::destroy_at(this->data + i);
           }
 #ifdef ROCKET_DEBUG
@@ -161,6 +176,38 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
         = delete;
       handle_storage & operator=(const handle_storage &)
         = delete;
+
+      const unsigned char * tags() const noexcept
+        {
+          return reinterpret_cast<const unsigned char *>(this->data + this->nbkt);
+        }
+      unsigned char * tags() noexcept
+        {
+          return reinterpret_cast<unsigned char *>(this->data + this->nbkt);
+        }
+
+      // Allocates storage for an element that is to be put into `bkt`. The element is not constructed.
+      pointer allocate_element(const handle_type *bkt)
+        {
+          if(this->nslot == 0) {
+            return allocator_traits<allocator_type>::allocate(this->alloc, size_t(1));
+          }
+          // In small mode, use the inline slot of this bucket.
+          static_assert(alignof(value_type) <= alignof(handle_storage), "`value_type` is over-aligned.");
+          const auto slots = reinterpret_cast<value_type *>(this + min_nblk_for_nbkt(this->nbkt));
+          const auto i = static_cast<size_type>(bkt - this->data);
+          ROCKET_ASSERT(i < this->nslot);
+          return ::std::pointer_traits<pointer>::pointer_to(slots[i]);
+        }
+      // Deallocates storage for an element that has been destroyed.
+      void deallocate_element(pointer eptr) noexcept
+        {
+          if(this->nslot != 0) {
+            // In small mode, inline slots are never deallocated.
+            return;
+          }
+          allocator_traits<allocator_type>::deallocate(this->alloc, eptr, size_t(1));
+        }
     };
 
   // Copies the `const` qualifier from `otherT`, which may be a reference type, to `typeT`.
@@ -181,7 +228,7 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
         static size_type origin(xpointerT ptr, size_t hval)
         {
           static_assert(is_same<typename decay<decltype(*ptr)>::type, handle_storage<allocatorT>>::value, "???");
-          const auto nbkt = handle_storage<allocatorT>::max_nbkt_for_nblk(ptr->nblk);
+          const auto nbkt = ptr->nbkt;
           // Conversion between an unsigned integer type and a floating point type results in performance penalty.
           // For a value known to be non-negative, an intermediate cast to some signed integer type will mitigate this.
           const auto fcast = [](size_t x) { return static_cast<double>(static_cast<ptrdiff_t>(x)); };
@@ -194,12 +241,19 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           ROCKET_ASSERT(pos < nbkt);
           return pos;
         }
+      // The tag of an empty bucket is zero.
+      // The tag of a non-empty bucket has its MSB set, and its other bits are taken from the hash value of the key.
+      static unsigned char tag(size_t hval) noexcept
+        {
+          const auto seed = static_cast<uint32_t>(hval * 0xBA0DC66B);
+          return static_cast<unsigned char>(0x80 | (seed & 0x7F));
+        }
 
       template<typename xpointerT, typename predT>
         static typename copy_const_from<handle_type, decltype(*(::std::declval<xpointerT>()))>::type * probe(xpointerT ptr, size_type first, size_type last, predT &&pred)
         {
           static_assert(is_same<typename decay<decltype(*ptr)>::type, handle_storage<allocatorT>>::value, "???");
-          const auto nbkt = handle_storage<allocatorT>::max_nbkt_for_nblk(ptr->nblk);
+          const auto nbkt = ptr->nbkt;
           // Phase one: Probe from `first` to the end of the table.
           for(size_type i = first; i != nbkt; ++i) {
             const auto bkt = ptr->data + i;
@@ -217,8 +271,85 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           // The table is full and no desired element has been found so far.
           return nullptr;
         }
+
+      // Returns a bit mask of tags in `[tptr, tptr + n)` that are either empty or equal to `tval`, where `n` is no more than 16.
+      static unsigned match_tags(const unsigned char *tptr, size_type n, unsigned char tval) noexcept
+        {
+          ROCKET_ASSERT(n <= 16);
+#ifdef __SSE2__
+          if(n == 16) {
+            const auto group = _mm_loadu_si128(reinterpret_cast<const __m128i *>(tptr));
+            const auto hits = _mm_or_si128(_mm_cmpeq_epi8(group, _mm_setzero_si128()), _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tval))));
+            return static_cast<unsigned>(_mm_movemask_epi8(hits));
+          }
+#endif
+          unsigned mask = 0;
+          for(size_type i = 0; i != n; ++i) {
+            if((tptr[i] == 0) || (tptr[i] == tval)) {
+              mask |= 1u << i;
+            }
+          }
+          return mask;
+        }
+      template<typename xpointerT, typename predT>
+        static typename copy_const_from<handle_type, decltype(*(::std::declval<xpointerT>()))>::type * do_probe_tagged_range(xpointerT ptr, size_type first, size_type last, unsigned char tval, predT &&pred)
+        {
+          const auto tptr = ptr->tags();
+          auto i = first;
+          while(i != last) {
+            // Scan tags in groups, skipping buckets whose tags differ.
+            const auto n = noadl::min(last - i, size_type(16));
+            auto mask = match_tags(tptr + i, n, tval);
+            for(auto bkt = ptr->data + i; mask != 0; ++bkt, mask >>= 1) {
+              if((mask & 1) == 0) {
+                continue;
+              }
+              if(!bkt->get() || ::std::forward<predT>(pred)(bkt)) {
+                return bkt;
+              }
+            }
+            i += n;
+          }
+          return nullptr;
+        }
+      // This function works the same way as `probe()`, but `pred` is only called on buckets whose tags equal `tval`.
+      template<typename xpointerT, typename predT>
+        static typename copy_const_from<handle_type, decltype(*(::std::declval<xpointerT>()))>::type * probe_tagged(xpointerT ptr, size_type first, size_type last, unsigned char tval, predT &&pred)
+        {
+          static_assert(is_same<typename decay<decltype(*ptr)>::type, handle_storage<allocatorT>>::value, "???");
+          const auto nbkt = ptr->nbkt;
+          // Phase one: Probe from `first` to the end of the table.
+          auto bkt = do_probe_tagged_range(ptr, first, nbkt, tval, pred);
+          if(bkt) {
+            return bkt;
+          }
+          // Phase two: Probe from the beginning of the table to `last`.
+          bkt = do_probe_tagged_range(ptr, 0, last, tval, pred);
+          if(bkt) {
+            return bkt;
+          }
+          // The table is full and no desired element has been found so far.
+          return nullptr;
+        }
     };
 
+  // Finds an empty bucket for a new element whose key is `ykey`, and stores its tag into `tval`.
+  // The tag shall not be written into the table before the bucket is filled.
+  template<typename allocatorT, typename xpointerT, typename hashT, typename ykeyT>
+    inline value_handle<allocatorT> * find_empty_bucket(xpointerT ptr, const hashT &hf, const ykeyT &ykey, unsigned char &tval)
+    {
+      static_assert(is_same<typename decay<decltype(*ptr)>::type, handle_storage<allocatorT>>::value, "???");
+      if(ptr->nslot != 0) {
+        // In small mode, the key is not hashed. Search the table linearly.
+        tval = 0;
+        return linear_prober<allocatorT>::probe(ptr, 0, 0, [](const void *) { return false; });
+      }
+      const auto hval = hf(ykey);
+      const auto origin = linear_prober<allocatorT>::origin(ptr, hval);
+      tval = linear_prober<allocatorT>::tag(hval);
+      return linear_prober<allocatorT>::probe_tagged(ptr, origin, origin, tval, [](const void *) { return false; });
+    }
+
   template<typename allocatorT, typename hashT, bool copyableT = is_copy_constructible<typename allocatorT::value_type>::value>
     struct copy_storage_helper
     {
@@ -234,20 +365,21 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
               continue;
             }
             // Find a bucket for the new element.
-            const auto origin = linear_prober<allocatorT>::origin(ptr, hf(eptr_old->first));
-            const auto bkt = linear_prober<allocatorT>::probe(ptr, origin, origin, [](const void *) { return false; });
+            unsigned char tval;
+            const auto bkt = find_empty_bucket<allocatorT>(ptr, hf, eptr_old->first, tval);
             ROCKET_ASSERT(bkt);
             // Allocate a new element by copy-constructing from the old one.
-            auto eptr = allocator_traits<allocatorT>::allocate(ptr->alloc, size_t(1));
+            auto eptr = ptr->allocate_element(bkt);
             try {
               allocator_traits<allocatorT>::construct(ptr->alloc, noadl::unfancy(eptr), *eptr_old);
             } catch(...) {
-              allocator_traits<allocatorT>::deallocate(ptr->alloc, eptr, size_t(1));
+              ptr->deallocate_element(eptr);
               throw;
             }
             // Insert it into the new bucket.
             eptr = bkt->set(eptr);
             ROCKET_ASSERT(!eptr);
+            ptr->tags()[bkt - ptr->data] = tval;
             ptr->nelem += 1;
           }
         }
@@ -280,15 +412,30 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
               continue;
             }
             // Find a bucket for the new element.
-            const auto origin = linear_prober<allocatorT>::origin(ptr, hf(eptr_old->first));
-            const auto bkt = linear_prober<allocatorT>::probe(ptr, origin, origin, [](const void *) { return false; });
+            unsigned char tval;
+            const auto bkt = find_empty_bucket<allocatorT>(ptr, hf, eptr_old->first, tval);
             ROCKET_ASSERT(bkt);
+            auto eptr = eptr_old;
+            if((ptr->nslot != 0) || (ptr_old->nslot != 0)) {
+              // Elements in inline slots cannot be transferred. Move-construct a new element from the old one.
+              eptr = ptr->allocate_element(bkt);
+              try {
+                allocator_traits<allocatorT>::construct(ptr->alloc, noadl::unfancy(eptr), ::std::move(*eptr_old));
+              } catch(...) {
+                ptr->deallocate_element(eptr);
+                throw;
+              }
+              allocator_traits<allocatorT>::destroy(ptr_old->alloc, noadl::unfancy(eptr_old));
+              ptr_old->deallocate_element(eptr_old);
+            }
             // Detach the old element.
-            auto eptr = ptr_old->data[i].set(nullptr);
+            ptr_old->data[i].set(nullptr);
+            ptr_old->tags()[i] = 0;
             ptr_old->nelem -= 1;
             // Insert it into the new bucket.
             eptr = bkt->set(eptr);
             ROCKET_ASSERT(!eptr);
+            ptr->tags()[bkt - ptr->data] = tval;
             ptr->nelem += 1;
           }
         }
@@ -320,7 +467,8 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
       using size_type        = typename allocator_traits<allocator_type>::size_type;
       using difference_type  = typename allocator_traits<allocator_type>::difference_type;
 
-      enum : size_type { max_load_factor_reciprocal = 2 };
+      // Tables that can hold no more than `max_small_capacity` elements are created in small mode, where elements are stored in-place and keys are searched for linearly.
+      enum : size_type { max_load_factor_reciprocal = 2, max_small_capacity = 8 };
 
     private:
       using allocator_base    = typename allocator_wrapper_base_for<allocator_type>::type;
@@ -434,13 +582,21 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           }
           return ptr->nref.load(::std::memory_order_relaxed) == 1;
         }
+      long use_count() const noexcept
+        {
+          const auto ptr = this->m_ptr;
+          if(!ptr) {
+            return 0;
+          }
+          return ptr->nref.load(::std::memory_order_relaxed);
+        }
       size_type bucket_count() const noexcept
         {
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return 0;
           }
-          return storage::max_nbkt_for_nblk(ptr->nblk);
+          return ptr->nbkt;
         }
       size_type capacity() const noexcept
         {
@@ -448,7 +604,10 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           if(!ptr) {
             return 0;
           }
-          return storage::max_nbkt_for_nblk(ptr->nblk) / max_load_factor_reciprocal;
+          if(ptr->nslot != 0) {
+            return ptr->nslot;
+          }
+          return ptr->nbkt / max_load_factor_reciprocal;
         }
       size_type max_size() const noexcept
         {
@@ -469,6 +628,9 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
       size_type round_up_capacity(size_type res_arg) const
         {
           const auto cap = this->check_size_add(0, res_arg);
+          if(cap <= max_small_capacity) {
+            return cap;
+          }
           const auto nblk = storage::min_nblk_for_nbkt(cap * max_load_factor_reciprocal);
           return storage::max_nbkt_for_nblk(nblk) / max_load_factor_reciprocal;
         }
@@ -497,13 +659,15 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           }
           const auto cap = this->check_size_add(0, res_arg);
           // Allocate an array of `storage` large enough for a header + `cap` instances of pointers.
-          const auto nblk = storage::min_nblk_for_nbkt(cap * max_load_factor_reciprocal);
+          // In small mode, there is exactly one bucket for each element, plus space for the element itself.
+          const auto nslot = (cap <= max_small_capacity) ? cap : 0;
+          const auto nblk = (nslot != 0) ? storage::min_nblk_for_nslot(nslot) : storage::min_nblk_for_nbkt(cap * max_load_factor_reciprocal);
           auto st_alloc = storage_allocator(this->as_allocator());
           const auto ptr = allocator_traits<storage_allocator>::allocate(st_alloc, nblk);
 #ifdef ROCKET_DEBUG
           ::std::memset(static_cast<void *>(noadl::unfancy(ptr)), '*', sizeof(storage) * nblk);
 #endif
-          noadl::construct_at(noadl::unfancy(ptr), this->as_allocator(), nblk);
+          noadl::construct_at(noadl::unfancy(ptr), this->as_allocator(), nblk, nslot);
           const auto ptr_old = this->m_ptr;
           if(ptr_old) {
             try {
@@ -565,15 +729,28 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           return this;
         }
 
+      // If `hval_opt` is non-null, it shall point to the hash value of `ykey`.
       template<typename ykeyT>
-        difference_type index_of(const ykeyT &ykey) const
+        difference_type index_of(const ykeyT &ykey, const size_t *hval_opt = nullptr) const
         {
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return -1;
           }
-          const auto origin = linear_prober<allocator_type>::origin(ptr, this->as_hasher()(ykey));
-          const auto bkt = linear_prober<allocator_type>::probe(ptr, origin, origin,
+          if(ptr->nslot != 0) {
+            // In small mode, the key is not hashed. Search the table linearly.
+            for(size_type i = 0; i != ptr->nbkt; ++i) {
+              const auto eptr = ptr->data[i].get();
+              if(eptr && this->as_key_equal()(eptr->first, ykey)) {
+                return static_cast<difference_type>(i);
+              }
+            }
+            return -1;
+          }
+          const auto hval = hval_opt ? *hval_opt : this->as_hasher()(ykey);
+          const auto origin = linear_prober<allocator_type>::origin(ptr, hval);
+          const auto tval = linear_prober<allocator_type>::tag(hval);
+          const auto bkt = linear_prober<allocator_type>::probe_tagged(ptr, origin, origin, tval,
             [&](const value_handle<allocatorT> *tbkt)
               { return this->as_key_equal()(tbkt->get()->first, ykey); }
             );
@@ -596,35 +773,59 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           ROCKET_ASSERT(this->unique());
           return ptr->data;
         }
+      // If `hval_opt` is non-null, it shall point to the hash value of `ykey`.
       template<typename ykeyT, typename ...paramsT>
-        pair<handle_type *, bool> keyed_emplace_unchecked(const ykeyT &ykey, paramsT &&...params)
+        pair<handle_type *, bool> keyed_emplace_unchecked(const ykeyT &ykey, const size_t *hval_opt, paramsT &&...params)
         {
           ROCKET_ASSERT(this->unique());
           ROCKET_ASSERT(this->element_count() < this->capacity());
           const auto ptr = this->m_ptr;
           ROCKET_ASSERT(ptr);
           // Find a bucket for the new element.
-          const auto origin = linear_prober<allocator_type>::origin(ptr, this->as_hasher()(ykey));
-          const auto bkt = linear_prober<allocator_type>::probe(ptr, origin, origin,
-            [&](const value_handle<allocatorT> *tbkt)
-              { return this->as_key_equal()(tbkt->get()->first, ykey); }
-            );
+          handle_type *bkt = nullptr;
+          unsigned char tval = 0;
+          if(ptr->nslot != 0) {
+            // In small mode, the key is not hashed. Search the table linearly.
+            for(size_type i = 0; i != ptr->nbkt; ++i) {
+              const auto tbkt = ptr->data + i;
+              if(!tbkt->get()) {
+                // Remember the first empty bucket.
+                if(!bkt) {
+                  bkt = tbkt;
+                }
+                continue;
+              }
+              if(this->as_key_equal()(tbkt->get()->first, ykey)) {
+                // A duplicate key has been found.
+                return ::std::make_pair(tbkt, false);
+              }
+            }
+          } else {
+            const auto hval = hval_opt ? *hval_opt : this->as_hasher()(ykey);
+            const auto origin = linear_prober<allocator_type>::origin(ptr, hval);
+            tval = linear_prober<allocator_type>::tag(hval);
+            bkt = linear_prober<allocator_type>::probe_tagged(ptr, origin, origin, tval,
+              [&](const value_handle<allocatorT> *tbkt)
+                { return this->as_key_equal()(tbkt->get()->first, ykey); }
+              );
+          }
           ROCKET_ASSERT(bkt);
           if(bkt->get()) {
             // A duplicate key has been found.
             return ::std::make_pair(bkt, false);
           }
           // Allocate a new element.
-          auto eptr = allocator_traits<allocator_type>::allocate(ptr->alloc, size_t(1));
+          auto eptr = ptr->allocate_element(bkt);
           try {
             allocator_traits<allocator_type>::construct(ptr->alloc, noadl::unfancy(eptr), ::std::forward<paramsT>(params)...);
           } catch(...) {
-            allocator_traits<allocatorT>::deallocate(ptr->alloc, eptr, size_t(1));
+            ptr->deallocate_element(eptr);
             throw;
           }
           // Insert it into the new bucket.
           eptr = bkt->set(eptr);
           ROCKET_ASSERT(!eptr);
+          ptr->tags()[bkt - ptr->data] = tval;
           ptr->nelem += 1;
           return ::std::make_pair(bkt, true);
         }
@@ -638,18 +839,22 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
           }
           const auto ptr = this->m_ptr;
           ROCKET_ASSERT(ptr);
-          const auto nbkt = storage::max_nbkt_for_nblk(ptr->nblk);
-          ROCKET_ASSERT(nbkt != 0);
+          ROCKET_ASSERT(ptr->nbkt != 0);
           // Erase all elements in [tpos,tpos+tn).
           for(auto i = tpos; i != tpos + tn; ++i) {
             const auto eptr = ptr->data[i].set(nullptr);
             if(!eptr) {
               continue;
             }
+            ptr->tags()[i] = 0;
             ptr->nelem -= 1;
             // Destroy the element and deallocate its storage.
             allocator_traits<allocator_type>::destroy(ptr->alloc, noadl::unfancy(eptr));
-            allocator_traits<allocator_type>::deallocate(ptr->alloc, eptr, size_t(1));
+            ptr->deallocate_element(eptr);
+          }
+          if(ptr->nslot != 0) {
+            // In small mode, elements are not hashed, so there is nothing to relocate.
+            return;
           }
           // Relocate elements that are not placed in their immediate locations.
           linear_prober<allocator_type>::probe(ptr, tpos + tn, tpos,
@@ -657,13 +862,17 @@ template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename
               {
                 // Remove the element from the old bucket.
                 auto eptr = tbkt->set(nullptr);
+                ptr->tags()[tbkt - ptr->data] = 0;
                 // Find a new bucket for it.
-                const auto origin = linear_prober<allocator_type>::origin(ptr, this->as_hasher()(eptr->first));
-                const auto bkt = linear_prober<allocator_type>::probe(ptr, origin, origin, [&](const void *) { return false; });
+                const auto hval = this->as_hasher()(eptr->first);
+                const auto origin = linear_prober<allocator_type>::origin(ptr, hval);
+                const auto tval = linear_prober<allocator_type>::tag(hval);
+                const auto bkt = linear_prober<allocator_type>::probe_tagged(ptr, origin, origin, tval, [&](const void *) { return false; });
                 ROCKET_ASSERT(bkt);
                 // Insert it into the new bucket.
                 eptr = bkt->set(eptr);
                 ROCKET_ASSERT(!eptr);
+                ptr->tags()[bkt - ptr->data] = tval;
                 return false;
               }
             );
@@ -987,12 +1196,22 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
         ROCKET_ASSERT(tpos <= nbkt_old);
         ROCKET_ASSERT(tn <= nbkt_old - tpos);
         if(!this->unique()) {
+          // Elements before `tpos` are copied first. In small mode, they fill the first buckets in order.
+          const auto table = this->do_get_table();
+          size_type cnt_before = 0;
+          for(size_type i = 0; i != tpos; ++i) {
+            cnt_before += (table[i].get() != nullptr);
+          }
           const auto ptr = this->do_reallocate(tpos, tpos + tn, nbkt_old - (tpos + tn), cnt_old);
-          return ptr;
+          if(!ptr || (this->bucket_count() > decltype(this->m_sth)::max_small_capacity)) {
+            return ptr;
+          }
+          return ptr + cnt_before;
         }
         const auto ptr = this->m_sth.mut_data_unchecked();
         this->m_sth.erase_range_unchecked(tpos, tn);
-        return ptr + tn;
+        // Elements that have been relocated into the erased range are yet to be visited.
+        return ptr + tpos;
       }
 
   public:
@@ -1064,7 +1283,7 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
         if(!this->unique() || (this->capacity() <= cap_min)) {
           return;
         }
-        this->do_reallocate(0, 0, cnt, cnt);
+        this->do_reallocate(0, 0, this->bucket_count(), cnt);
         ROCKET_ASSERT(this->capacity() <= cap_min);
       }
     void clear() noexcept
@@ -1080,6 +1299,18 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       {
         return this->m_sth.unique();
       }
+    // N.B. This is a non-standard extension.
+    long use_count() const noexcept
+      {
+        return this->m_sth.use_count();
+      }
+    // N.B. This is a non-standard extension.
+    // Returns a pointer that identifies the table, which is shared by copies of this hashmap until they are modified.
+    // If this hashmap has no storage, a null pointer is returned.
+    const void * storage_id() const noexcept
+      {
+        return this->m_sth.data();
+      }
 
     // hash policy
     // N.B. This is a non-standard extension.
@@ -1137,7 +1368,7 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
           return *this;
         }
         this->do_reserve_more(dist);
-        noadl::ranged_do_while(::std::move(first), ::std::move(last), [&](const inputT &it) { this->m_sth.keyed_emplace_unchecked(it->first, *it); });
+        noadl::ranged_do_while(::std::move(first), ::std::move(last), [&](const inputT &it) { this->m_sth.keyed_emplace_unchecked(it->first, nullptr, *it); });
         return *this;
       }
     // N.B. The return type is a non-standard extension.
@@ -1174,7 +1405,7 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       pair<iterator, bool> try_emplace(const key_type &key, paramsT &&...params)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, ::std::piecewise_construct,
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, ::std::piecewise_construct,
                                                                 ::std::forward_as_tuple(key), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
         return ::std::make_pair(iterator(this->m_sth, result.first), result.second);
       }
@@ -1182,10 +1413,20 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       pair<iterator, bool> try_emplace(key_type &&key, paramsT &&...params)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, ::std::piecewise_construct,
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, ::std::piecewise_construct,
                                                                 ::std::forward_as_tuple(::std::move(key)), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
         return ::std::make_pair(iterator(this->m_sth, result.first), result.second);
       }
+    // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    template<typename ...paramsT>
+      pair<iterator, bool> try_emplace_with_hash(const key_type &key, size_t hval, paramsT &&...params)
+      {
+        this->do_reserve_more(1);
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, &hval, ::std::piecewise_construct,
+                                                                ::std::forward_as_tuple(key), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
+        return ::std::make_pair(iterator(this->m_sth, result.first), result.second);
+      }
     // N.B. The hint is ignored.
     template<typename ...paramsT>
       iterator try_emplace(const_iterator /*hint*/, const key_type &key, paramsT &&...params)
@@ -1203,7 +1444,7 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       pair<iterator, bool> insert_or_assign(const key_type &key, yvalueT &&yvalue)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, key, ::std::forward<yvalueT>(yvalue));
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, key, ::std::forward<yvalueT>(yvalue));
         if(!result.second) {
           result.first->get()->second = ::std::forward<yvalueT>(yvalue);
         }
@@ -1213,7 +1454,7 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       pair<iterator, bool> insert_or_assign(key_type &&key, yvalueT &&yvalue)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, ::std::move(key), ::std::forward<yvalueT>(yvalue));
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, ::std::move(key), ::std::forward<yvalueT>(yvalue));
         if(!result.second) {
           result.first->get()->second = ::std::forward<yvalueT>(yvalue);
         }
@@ -1270,6 +1511,17 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
         }
         return const_iterator(this->m_sth, ptr + toff);
       }
+    // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    const_iterator find(const key_type &key, size_t hval) const
+      {
+        const auto ptr = this->do_get_table();
+        const auto toff = this->m_sth.index_of(key, &hval);
+        if(toff < 0) {
+          return this->end();
+        }
+        return const_iterator(this->m_sth, ptr + toff);
+      }
     pair<const_iterator, const_iterator> equal_range(const key_type &key) const
       {
         const auto ptr = this->do_get_table();
@@ -1297,6 +1549,18 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
       }
     // N.B. This function may throw `std::bad_alloc`.
     // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    iterator find_mut(const key_type &key, size_t hval)
+      {
+        const auto ptr = this->do_mut_table();
+        const auto toff = this->m_sth.index_of(key, &hval);
+        if(toff < 0) {
+          return this->mut_end();
+        }
+        return iterator(this->m_sth, ptr + toff);
+      }
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. This is a non-standard extension.
     pair<iterator, iterator> mut_equal_range(const key_type &key)
       {
         const auto ptr = this->do_mut_table();
@@ -1344,14 +1608,14 @@ template<typename keyT, typename mappedT, typename hashT, typename eqT, typename
     mapped_type & operator[](const key_type &key)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, ::std::piecewise_construct,
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, ::std::piecewise_construct,
                                                                 ::std::forward_as_tuple(key), ::std::forward_as_tuple());
         return result.first->get()->second;
       }
     mapped_type & operator[](key_type &&key)
       {
         this->do_reserve_more(1);
-        const auto result = this->m_sth.keyed_emplace_unchecked(key, ::std::piecewise_construct,
+        const auto result = this->m_sth.keyed_emplace_unchecked(key, nullptr, ::std::piecewise_construct,
                                                                 ::std::forward_as_tuple(::std::move(key)), ::std::forward_as_tuple());
         return result.first->get()->second;
       }
@@ -0,0 +1,1438 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ROCKET_COW_HASHTRIE_HPP_
+#define ROCKET_COW_HASHTRIE_HPP_
+
+#include <memory> // std::allocator<>, std::allocator_traits<>, std::pointer_traits<>
+#include <atomic> // std::atomic<>
+#include <type_traits> // so many...
+#include <iterator> // std::iterator_traits<>, std::forward_iterator_tag
+#include <initializer_list> // std::initializer_list<>
+#include <utility> // std::move(), std::forward(), std::pair<>
+#include <tuple> // std::forward_as_tuple()
+#include <typeinfo> // typeid()
+#include <functional> // std::hash<>
+#include <limits> // std::numeric_limits<>
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <cstring> // std::memset()
+#include <cstdint> // std::uint32_t
+#include "compatibility.h"
+#include "assert.hpp"
+#include "throw.hpp"
+#include "utilities.hpp"
+#include "allocator_utilities.hpp"
+#include "transparent_comparators.hpp"
+
+/* Differences from `std::unordered_map`:
+ * 1. `begin()` and `end()` always return `const_iterator`s. `at()` always returns `const_reference`s.
+ * 2. The copy constructor and copy assignment operator will not throw exceptions.
+ * 3. Comparison operators are not provided.
+ * 4. `emplace()` and `emplace_hint()` functions are not provided. `try_emplace()` is recommended as an alternative.
+ * 5. There are no buckets. Bucket lookups, local iterators and the hash policy are not provided. The non-unique (`unordered_multimap`) equivalent cannot be implemented.
+ * 6. The key and mapped types may be incomplete. The mapped type need be neither copy-assignable nor move-assignable.
+ * 7. Any modification may move elements around and invalidate iterators.
+ * 8. Elements are stored in a hash array mapped trie, whose nodes are shared and copied individually. Modifying a shared hashtrie copies only nodes on the path to the element being modified.
+ * 9. A hashtrie that has no more than 8 elements consists of a single leaf, where keys are searched for linearly.
+ */
+
+namespace rocket {
+
+using ::std::allocator;
+using ::std::allocator_traits;
+using ::std::atomic;
+using ::std::is_same;
+using ::std::decay;
+using ::std::remove_reference;
+using ::std::is_array;
+using ::std::is_const;
+using ::std::enable_if;
+using ::std::is_convertible;
+using ::std::is_copy_constructible;
+using ::std::is_nothrow_constructible;
+using ::std::is_nothrow_copy_constructible;
+using ::std::is_nothrow_move_constructible;
+using ::std::conditional;
+using ::std::iterator_traits;
+using ::std::initializer_list;
+using ::std::pair;
+using ::std::hash;
+using ::std::size_t;
+using ::std::ptrdiff_t;
+using ::std::uint32_t;
+
+template<typename keyT, typename mappedT, typename hashT = hash<keyT>, typename eqT = transparent_equal_to, typename allocatorT = allocator<pair<const keyT, mappedT>>>
+  class cow_hashtrie;
+
+  namespace details_cow_hashtrie {
+
+  // Returns the number of one bits in `bmap`.
+  inline unsigned popcount(uint32_t bmap) noexcept
+    {
+      auto word = bmap - ((bmap >> 1) & 0x55555555);
+      word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+      word = (word + (word >> 4)) & 0x0F0F0F0F;
+      return static_cast<unsigned>((word * 0x01010101) >> 24);
+    }
+
+  template<typename allocatorT>
+    struct trie_node
+    {
+      using allocator_type   = allocatorT;
+      using value_type       = typename allocator_type::value_type;
+      using size_type        = typename allocator_traits<allocator_type>::size_type;
+      using node_allocator   = typename allocator_traits<allocator_type>::template rebind_alloc<trie_node>;
+      using node_pointer     = typename allocator_traits<node_allocator>::pointer;
+
+      // Each branch has up to 32 children, which are indexed by 5 bits of hash values, from the least significant bits.
+      // Each leaf has up to 8 elements, unless all bits of hash values have been consumed, in which case elements collide.
+      enum : size_type { bits_per_level = 5, max_branch_size = 32, max_leaf_size = 8 };
+      enum : size_type { max_shift = ::std::numeric_limits<size_t>::digits, max_depth = (max_shift + bits_per_level - 1) / bits_per_level };
+
+      // Returns the index of the child of a branch at `shift` that a key with the hash value `hval` belongs to.
+      static constexpr unsigned child_index(size_t hval, size_type shift) noexcept
+        {
+          return (shift < max_shift) ? static_cast<unsigned>((hval >> shift) & (max_branch_size - 1)) : 0;
+        }
+
+      // Elements of a leaf follow their hash values.
+      static constexpr size_type values_offset(size_type ncap) noexcept
+        {
+          return (ncap * sizeof(size_t) + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+      static constexpr size_type min_nblk_for_leaf(size_type ncap) noexcept
+        {
+          return (values_offset(ncap) + ncap * sizeof(value_type) + sizeof(trie_node) - 1) / sizeof(trie_node) + 1;
+        }
+      static constexpr size_type min_nblk_for_branch(size_type ncap) noexcept
+        {
+          return (ncap * sizeof(trie_node *) + sizeof(trie_node) - 1) / sizeof(trie_node) + 1;
+        }
+
+      atomic<long> nref;
+      allocator_type alloc;
+      size_type nblk;
+      bool leaf;
+      uint32_t bmap;
+      size_type nused;
+      size_type ncap;
+
+      trie_node(const allocator_type &xalloc, size_type xnblk, bool xleaf, size_type xncap) noexcept
+        : alloc(xalloc), nblk(xnblk), leaf(xleaf), bmap(0), nused(0), ncap(xncap)
+        {
+          this->nref.store(1, ::std::memory_order_release);
+        }
+      ~trie_node()
+        {
+          if(this->leaf) {
+            for(size_type i = 0; i < this->nused; ++i) {
+              allocator_traits<allocator_type>::destroy(this->alloc, this->values() + i);
+            }
+          } else {
+            for(size_type i = 0; i < this->nused; ++i) {
+              release(this->children()[i]);
+            }
+          }
+#ifdef ROCKET_DEBUG
+          this->nused = 0xEECD;
+#endif
+        }
+
+      trie_node(const trie_node &)
+        = delete;
+      trie_node & operator=(const trie_node &)
+        = delete;
+
+      // Allocates a node. Its reference count is initialized to one.
+      static trie_node * create(const allocator_type &alloc, bool leaf, size_type ncap)
+        {
+          static_assert(alignof(value_type) <= alignof(trie_node), "`value_type` is over-aligned.");
+          const auto nblk = leaf ? min_nblk_for_leaf(ncap) : min_nblk_for_branch(ncap);
+          auto nd_alloc = node_allocator(alloc);
+          const auto ptr = noadl::unfancy(allocator_traits<node_allocator>::allocate(nd_alloc, nblk));
+#ifdef ROCKET_DEBUG
+          ::std::memset(static_cast<void *>(ptr), '*', sizeof(trie_node) * nblk);
+#endif
+          return noadl::construct_at(ptr, alloc, nblk, leaf, ncap);
+        }
+      // Decrements the reference count of a node and deallocates it if the reference count reaches zero.
+      static void release(trie_node *ptr) noexcept
+        {
+          // Decrement the reference count with acquire-release semantics to prevent races on `ptr->alloc`.
+          const auto nref_old = ptr->nref.fetch_sub(1, ::std::memory_order_acq_rel);
+          if(nref_old > 1) {
+            return;
+          }
+          ROCKET_ASSERT(nref_old == 1);
+          auto nd_alloc = node_allocator(ptr->alloc);
+          const auto nblk = ptr->nblk;
+          const auto fptr = ::std::pointer_traits<node_pointer>::pointer_to(*ptr);
+          noadl::destroy_at(ptr);
+#ifdef ROCKET_DEBUG
+          ::std::memset(static_cast<void *>(ptr), '~', sizeof(trie_node) * nblk);
+#endif
+          allocator_traits<node_allocator>::deallocate(nd_alloc, fptr, nblk);
+        }
+
+      bool unique() const noexcept
+        {
+          return this->nref.load(::std::memory_order_relaxed) == 1;
+        }
+      long use_count() const noexcept
+        {
+          return this->nref.load(::std::memory_order_relaxed);
+        }
+      // Returns `true` if a node below this one is shared, which is possible even if this node is not.
+      bool has_shared_descendants() const noexcept
+        {
+          if(this->leaf) {
+            return false;
+          }
+          for(size_type i = 0; i < this->nused; ++i) {
+            const auto child = this->children()[i];
+            if(!child->unique() || child->has_shared_descendants()) {
+              return true;
+            }
+          }
+          return false;
+        }
+      void add_ref() noexcept
+        {
+          const auto nref_old = this->nref.fetch_add(1, ::std::memory_order_relaxed);
+          ROCKET_ASSERT(nref_old >= 1);
+        }
+
+      // Children of a branch are sorted by their indices.
+      trie_node * const * children() const noexcept
+        {
+          ROCKET_ASSERT(!this->leaf);
+          return reinterpret_cast<trie_node * const *>(this + 1);
+        }
+      trie_node ** children() noexcept
+        {
+          ROCKET_ASSERT(!this->leaf);
+          return reinterpret_cast<trie_node **>(this + 1);
+        }
+      // Returns the position of the child whose index is `ci` in `children()`.
+      size_type child_rank(unsigned ci) const noexcept
+        {
+          return popcount(this->bmap & ((uint32_t(1) << ci) - 1));
+        }
+
+      const size_t * hashes() const noexcept
+        {
+          ROCKET_ASSERT(this->leaf);
+          return reinterpret_cast<const size_t *>(this + 1);
+        }
+      size_t * hashes() noexcept
+        {
+          ROCKET_ASSERT(this->leaf);
+          return reinterpret_cast<size_t *>(this + 1);
+        }
+      const value_type * values() const noexcept
+        {
+          ROCKET_ASSERT(this->leaf);
+          return reinterpret_cast<const value_type *>(reinterpret_cast<const char *>(this + 1) + values_offset(this->ncap));
+        }
+      value_type * values() noexcept
+        {
+          ROCKET_ASSERT(this->leaf);
+          return reinterpret_cast<value_type *>(reinterpret_cast<char *>(this + 1) + values_offset(this->ncap));
+        }
+    };
+
+  template<typename allocatorT, bool copyableT = is_copy_constructible<typename allocatorT::value_type>::value>
+    struct copy_element_helper
+    {
+      // This is the generic version.
+      void operator()(allocatorT &alloc, typename allocatorT::value_type *ptr, const typename allocatorT::value_type &src) const
+        {
+          allocator_traits<allocatorT>::construct(alloc, ptr, src);
+        }
+    };
+  template<typename allocatorT>
+    struct copy_element_helper<allocatorT, false>
+    {
+      // This specialization is used when `allocatorT::value_type` is not copy-constructible.
+      [[noreturn]] void operator()(allocatorT & /*alloc*/, typename allocatorT::value_type * /*ptr*/, const typename allocatorT::value_type & /*src*/) const
+        {
+          // `allocatorT::value_type` is not copy-constructible.
+          noadl::throw_domain_error("cow_hashtrie: `%s` is not copy-constructible.", typeid(typename allocatorT::value_type).name());
+        }
+    };
+
+  // Constructs an element in `dst` from `src`. If `to_move` is `true` and no exception would be thrown, the element is moved, otherwise it is copied.
+  template<typename allocatorT>
+    inline void transfer_element(allocatorT &alloc, typename allocatorT::value_type *dst, typename allocatorT::value_type &src, bool to_move)
+    {
+      if(is_nothrow_move_constructible<typename allocatorT::value_type>::value && to_move) {
+        allocator_traits<allocatorT>::construct(alloc, dst, ::std::move(src));
+        return;
+      }
+      copy_element_helper<allocatorT>()(alloc, dst, src);
+    }
+
+  template<typename typeT, typename otherT>
+    struct copy_const_from : conditional<is_const<typename remove_reference<otherT>::type>::value, const typeT, typeT>
+    {
+    };
+
+  // This struct is used as placeholders for EBO'd bases that would otherwise be duplicate, in order to prevent ambiguity.
+  template<int indexT>
+    struct ebo_placeholder
+    {
+      template<typename anythingT>
+        explicit constexpr ebo_placeholder(anythingT &&) noexcept
+        {
+        }
+    };
+
+  template<typename allocatorT, typename hashT, typename eqT>
+    class storage_handle : private allocator_wrapper_base_for<allocatorT>::type,
+                           private conditional<is_same<hashT, allocatorT>::value,
+                                               ebo_placeholder<0>, typename allocator_wrapper_base_for<hashT>::type>::type,
+                           private conditional<is_same<eqT, allocatorT>::value || is_same<eqT, hashT>::value,
+                                               ebo_placeholder<1>, typename allocator_wrapper_base_for<eqT>::type>::type
+    {
+    public:
+      using allocator_type   = allocatorT;
+      using value_type       = typename allocator_type::value_type;
+      using hasher           = hashT;
+      using key_equal        = eqT;
+      using node_type        = trie_node<allocator_type>;
+      using size_type        = typename allocator_traits<allocator_type>::size_type;
+      using difference_type  = typename allocator_traits<allocator_type>::difference_type;
+
+      // This denotes an element, which is the `second`-th element in leaf `first`. A null leaf denotes the past-the-end position.
+      using position        = pair<node_type *, size_type>;
+      using const_position  = pair<const node_type *, size_type>;
+
+    private:
+      using allocator_base    = typename allocator_wrapper_base_for<allocator_type>::type;
+      using hasher_base       = typename allocator_wrapper_base_for<hasher>::type;
+      using key_equal_base    = typename allocator_wrapper_base_for<key_equal>::type;
+
+    private:
+      node_type *m_root;
+      size_type m_nelem;
+
+    public:
+      constexpr storage_handle(const allocator_type &alloc, const hasher &hf, const key_equal &eq)
+        : allocator_base(alloc),
+          conditional<is_same<hashT, allocatorT>::value,
+                      ebo_placeholder<0>, hasher_base>::type(hf),
+          conditional<is_same<eqT, allocatorT>::value || is_same<eqT, hashT>::value,
+                      ebo_placeholder<1>, key_equal_base>::type(eq),
+          m_root(), m_nelem()
+        {
+        }
+      constexpr storage_handle(allocator_type &&alloc, const hasher &hf, const key_equal &eq)
+        : allocator_base(::std::move(alloc)),
+          conditional<is_same<hashT, allocatorT>::value,
+                      ebo_placeholder<0>, hasher_base>::type(hf),
+          conditional<is_same<eqT, allocatorT>::value || is_same<eqT, hashT>::value,
+                      ebo_placeholder<1>, key_equal_base>::type(eq),
+          m_root(), m_nelem()
+        {
+        }
+      ~storage_handle()
+        {
+          this->deallocate();
+        }
+
+      storage_handle(const storage_handle &)
+        = delete;
+      storage_handle & operator=(const storage_handle &)
+        = delete;
+
+    private:
+      // Makes the node `*pnode` owned exclusively by its parent, copying it if it is shared.
+      node_type * do_unshare_node(node_type **pnode)
+        {
+          const auto node = *pnode;
+          ROCKET_ASSERT(node);
+          if(node->unique()) {
+            return node;
+          }
+          const auto node_new = node_type::create(node->alloc, node->leaf, node->ncap);
+          if(node->leaf) {
+            try {
+              for(size_type i = 0; i < node->nused; ++i) {
+                copy_element_helper<allocator_type>()(node_new->alloc, node_new->values() + i, node->values()[i]);
+                node_new->hashes()[i] = node->hashes()[i];
+                node_new->nused = i + 1;
+              }
+            } catch(...) {
+              node_type::release(node_new);
+              throw;
+            }
+          } else {
+            // Share all children.
+            for(size_type i = 0; i < node->nused; ++i) {
+              const auto child = node->children()[i];
+              child->add_ref();
+              node_new->children()[i] = child;
+            }
+            node_new->bmap = node->bmap;
+            node_new->nused = node->nused;
+          }
+          *pnode = node_new;
+          node_type::release(node);
+          return node_new;
+        }
+      // Replaces the leaf `*pnode` with a new one which has room for `ncap` elements. Existing elements are moved if the old leaf is not shared.
+      node_type * do_reallocate_leaf(node_type **pnode, size_type ncap)
+        {
+          const auto node = *pnode;
+          ROCKET_ASSERT(node && node->leaf);
+          ROCKET_ASSERT(ncap >= node->nused);
+          const auto node_new = node_type::create(node->alloc, true, ncap);
+          const bool to_move = node->unique();
+          try {
+            for(size_type i = 0; i < node->nused; ++i) {
+              transfer_element(node_new->alloc, node_new->values() + i, node->values()[i], to_move);
+              node_new->hashes()[i] = node->hashes()[i];
+              node_new->nused = i + 1;
+            }
+          } catch(...) {
+            node_type::release(node_new);
+            throw;
+          }
+          *pnode = node_new;
+          node_type::release(node);
+          return node_new;
+        }
+      // Replaces the full leaf `*pnode`, which is at `shift`, with a branch, distributing its elements into new leaves.
+      node_type * do_split_leaf(node_type **pnode, size_type shift)
+        {
+          const auto node = *pnode;
+          ROCKET_ASSERT(node && node->leaf);
+          ROCKET_ASSERT(shift < node_type::max_shift);
+          uint32_t bmap = 0;
+          for(size_type i = 0; i < node->nused; ++i) {
+            bmap |= uint32_t(1) << node_type::child_index(node->hashes()[i], shift);
+          }
+          const auto node_new = node_type::create(node->alloc, false, popcount(bmap));
+          const bool to_move = node->unique();
+          try {
+            for(unsigned ci = 0; ci < node_type::max_branch_size; ++ci) {
+              if(!(bmap & (uint32_t(1) << ci))) {
+                continue;
+              }
+              size_type cnt = 0;
+              for(size_type i = 0; i < node->nused; ++i) {
+                cnt += node_type::child_index(node->hashes()[i], shift) == ci;
+              }
+              // Leave some room for elements to come.
+              const auto child = node_type::create(node->alloc, true, noadl::max(cnt, size_type(node_type::max_leaf_size / 2)));
+              node_new->children()[node_new->nused] = child;
+              node_new->nused += 1;
+              for(size_type i = 0; i < node->nused; ++i) {
+                if(node_type::child_index(node->hashes()[i], shift) != ci) {
+                  continue;
+                }
+                transfer_element(child->alloc, child->values() + child->nused, node->values()[i], to_move);
+                child->hashes()[child->nused] = node->hashes()[i];
+                child->nused += 1;
+              }
+            }
+          } catch(...) {
+            node_type::release(node_new);
+            throw;
+          }
+          node_new->bmap = bmap;
+          *pnode = node_new;
+          node_type::release(node);
+          return node_new;
+        }
+      // Inserts `child` into the branch `*pnode` as its `ci`-th child. The branch must not be shared.
+      // If an exception is thrown, `child` is released.
+      void do_insert_child(node_type **pnode, unsigned ci, node_type *child)
+        {
+          auto node = *pnode;
+          ROCKET_ASSERT(node && !node->leaf);
+          ROCKET_ASSERT(node->unique());
+          ROCKET_ASSERT(!(node->bmap & (uint32_t(1) << ci)));
+          if(node->nused == node->ncap) {
+            // Reallocate the branch. Children are transferred.
+            node_type *node_new;
+            try {
+              node_new = node_type::create(node->alloc, false, noadl::min(node->nused * 2, size_type(node_type::max_branch_size)));
+            } catch(...) {
+              node_type::release(child);
+              throw;
+            }
+            for(size_type i = 0; i < node->nused; ++i) {
+              node_new->children()[i] = node->children()[i];
+            }
+            node_new->bmap = node->bmap;
+            node_new->nused = node->nused;
+            node->nused = 0;
+            *pnode = node_new;
+            node_type::release(node);
+            node = node_new;
+          }
+          const auto rank = node->child_rank(ci);
+          for(auto i = node->nused; i != rank; --i) {
+            node->children()[i] = node->children()[i - 1];
+          }
+          node->children()[rank] = child;
+          node->bmap |= uint32_t(1) << ci;
+          node->nused += 1;
+        }
+      // Descends along the path of `hval`, making all nodes on the path owned exclusively by this hashtrie.
+      // The leaf that is reached is returned. The number of nodes that precede it is stored into `depth_out`.
+      node_type * do_unshare_path(node_type **(&pnodes)[node_type::max_depth + 1], unsigned (&cis)[node_type::max_depth + 1], size_type &depth_out, size_t hval)
+        {
+          auto pnode = &(this->m_root);
+          size_type depth = 0;
+          for(;;) {
+            const auto node = this->do_unshare_node(pnode);
+            pnodes[depth] = pnode;
+            if(node->leaf) {
+              break;
+            }
+            const auto ci = node_type::child_index(hval, depth * node_type::bits_per_level);
+            ROCKET_ASSERT(node->bmap & (uint32_t(1) << ci));
+            cis[depth] = ci;
+            pnode = node->children() + node->child_rank(ci);
+            depth += 1;
+          }
+          depth_out = depth;
+          return *pnode;
+        }
+
+    public:
+      const hasher & as_hasher() const noexcept
+        {
+          return static_cast<const hasher_base &>(*this);
+        }
+      hasher & as_hasher() noexcept
+        {
+          return static_cast<hasher_base &>(*this);
+        }
+
+      const key_equal & as_key_equal() const noexcept
+        {
+          return static_cast<const key_equal_base &>(*this);
+        }
+      key_equal & as_key_equal() noexcept
+        {
+          return static_cast<key_equal_base &>(*this);
+        }
+
+      const allocator_type & as_allocator() const noexcept
+        {
+          return static_cast<const allocator_base &>(*this);
+        }
+      allocator_type & as_allocator() noexcept
+        {
+          return static_cast<allocator_base &>(*this);
+        }
+
+      bool unique() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return false;
+          }
+          return root->unique();
+        }
+      long use_count() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return 0;
+          }
+          return root->use_count();
+        }
+      const void * root_id() const noexcept
+        {
+          return this->m_root;
+        }
+      bool has_shared_subtrees() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return false;
+          }
+          return root->has_shared_descendants();
+        }
+      size_type element_count() const noexcept
+        {
+          return this->m_nelem;
+        }
+      size_type max_size() const noexcept
+        {
+          auto nd_alloc = typename node_type::node_allocator(this->as_allocator());
+          const auto max_nblk = allocator_traits<typename node_type::node_allocator>::max_size(nd_alloc);
+          return max_nblk / 2 * sizeof(node_type) / (sizeof(size_t) + sizeof(value_type));
+        }
+      size_type check_size_add(size_type base, size_type add) const
+        {
+          const auto cap_max = this->max_size();
+          ROCKET_ASSERT(base <= cap_max);
+          if(cap_max - base < add) {
+            noadl::throw_length_error("cow_hashtrie: Increasing `%lld` by `%lld` would exceed the max size `%lld`.",
+                                      static_cast<long long>(base), static_cast<long long>(add), static_cast<long long>(cap_max));
+          }
+          return base + add;
+        }
+
+      void deallocate() noexcept
+        {
+          const auto root = noadl::exchange(this->m_root, nullptr);
+          this->m_nelem = 0;
+          if(!root) {
+            return;
+          }
+          node_type::release(root);
+        }
+
+      void share_with(const storage_handle &other) noexcept
+        {
+          const auto root = other.m_root;
+          if(root) {
+            // Increment the reference count.
+            root->add_ref();
+          }
+          const auto nelem = other.m_nelem;
+          this->deallocate();
+          this->m_root = root;
+          this->m_nelem = nelem;
+        }
+      void share_with(storage_handle &&other) noexcept
+        {
+          // Detach the trie.
+          const auto root = noadl::exchange(other.m_root, nullptr);
+          const auto nelem = noadl::exchange(other.m_nelem, size_type(0));
+          this->deallocate();
+          this->m_root = root;
+          this->m_nelem = nelem;
+        }
+      void exchange_with(storage_handle &other) noexcept
+        {
+          ::std::swap(this->m_root, other.m_root);
+          ::std::swap(this->m_nelem, other.m_nelem);
+        }
+
+      constexpr operator const storage_handle * () const noexcept
+        {
+          return this;
+        }
+      operator storage_handle * () noexcept
+        {
+          return this;
+        }
+
+      // Returns the position of the first element at or after the `idx`-th element of the leaf on the path of `hval`.
+      // If there is no such leaf, the position of the first element in the next leaf is returned.
+      const_position seek(size_t hval, size_type idx) const noexcept
+        {
+          const node_type *parents[node_type::max_depth];
+          unsigned cis[node_type::max_depth];
+          size_type depth = 0;
+          auto node = static_cast<const node_type *>(this->m_root);
+          if(!node) {
+            return const_position(nullptr, 0);
+          }
+          // Descend along the path of `hval`.
+          for(;;) {
+            if(node->leaf) {
+              if(idx < node->nused) {
+                return const_position(node, idx);
+              }
+              break;
+            }
+            const auto ci = node_type::child_index(hval, depth * node_type::bits_per_level);
+            parents[depth] = node;
+            cis[depth] = ci;
+            depth += 1;
+            if(!(node->bmap & (uint32_t(1) << ci))) {
+              break;
+            }
+            node = node->children()[node->child_rank(ci)];
+          }
+          // Ascend until a branch with a child after the current one is found.
+          while(depth != 0) {
+            depth -= 1;
+            const auto parent = parents[depth];
+            // N.B. If `cis[depth]` is 31, the mask is zero.
+            const auto rest = parent->bmap & ~((uint32_t(2) << cis[depth]) - 1);
+            if(rest == 0) {
+              continue;
+            }
+            node = parent->children()[parent->child_rank(popcount((rest & (0 - rest)) - 1))];
+            // Descend to the leftmost leaf.
+            while(!node->leaf) {
+              node = node->children()[0];
+            }
+            return const_position(node, 0);
+          }
+          return const_position(nullptr, 0);
+        }
+      // This function is similar to the other one, except that the leaf returned is owned exclusively by this hashtrie.
+      position seek(size_t hval, size_type idx)
+        {
+          const auto cpos = static_cast<const storage_handle *>(this)->seek(hval, idx);
+          if(!cpos.first) {
+            return position(nullptr, 0);
+          }
+          node_type **pnodes[node_type::max_depth + 1];
+          unsigned cis[node_type::max_depth + 1];
+          size_type depth;
+          const auto leaf = this->do_unshare_path(pnodes, cis, depth, cpos.first->hashes()[0]);
+          return position(leaf, cpos.second);
+        }
+
+      // If `hval_opt` is non-null, it shall point to the hash value of `ykey`.
+      template<typename ykeyT>
+        const_position find(const ykeyT &ykey, const size_t *hval_opt = nullptr) const
+        {
+          auto node = static_cast<const node_type *>(this->m_root);
+          if(!node) {
+            return const_position(nullptr, 0);
+          }
+          const auto hval = hval_opt ? *hval_opt : this->as_hasher()(ykey);
+          size_type shift = 0;
+          while(!node->leaf) {
+            const auto ci = node_type::child_index(hval, shift);
+            if(!(node->bmap & (uint32_t(1) << ci))) {
+              return const_position(nullptr, 0);
+            }
+            node = node->children()[node->child_rank(ci)];
+            shift += node_type::bits_per_level;
+          }
+          // Search the leaf linearly.
+          for(size_type i = 0; i < node->nused; ++i) {
+            if(node->hashes()[i] != hval) {
+              continue;
+            }
+            if(!(this->as_key_equal()(node->values()[i].first, ykey))) {
+              continue;
+            }
+            return const_position(node, i);
+          }
+          return const_position(nullptr, 0);
+        }
+      // Makes the element at `cpos` owned exclusively by this hashtrie.
+      position unshare(const_position cpos)
+        {
+          if(!cpos.first) {
+            return position(nullptr, 0);
+          }
+          node_type **pnodes[node_type::max_depth + 1];
+          unsigned cis[node_type::max_depth + 1];
+          size_type depth;
+          const auto leaf = this->do_unshare_path(pnodes, cis, depth, cpos.first->hashes()[cpos.second]);
+          return position(leaf, cpos.second);
+        }
+
+      // The key must not exist. `hval` shall be the hash value of the key of the element to create.
+      template<typename ...paramsT>
+        position emplace_unchecked(size_t hval, paramsT &&...params)
+        {
+          this->check_size_add(this->m_nelem, 1);
+          auto pnode = &(this->m_root);
+          size_type shift = 0;
+          node_type *leaf;
+          for(;;) {
+            auto node = *pnode;
+            if(!node) {
+              // Create a new leaf for this element, which may be the root.
+              node = node_type::create(this->as_allocator(), true, 1);
+              try {
+                allocator_traits<allocator_type>::construct(node->alloc, node->values(), ::std::forward<paramsT>(params)...);
+              } catch(...) {
+                node_type::release(node);
+                throw;
+              }
+              node->hashes()[0] = hval;
+              node->nused = 1;
+              *pnode = node;
+              leaf = node;
+              break;
+            }
+            if(node->leaf) {
+              if((node->nused >= node_type::max_leaf_size) && (shift < node_type::max_shift)) {
+                // Split this leaf and retry.
+                this->do_split_leaf(pnode, shift);
+                continue;
+              }
+              if(!node->unique() || (node->nused >= node->ncap)) {
+                // Reallocate this leaf with some more room.
+                auto ncap = node->ncap;
+                if(node->nused >= ncap) {
+                  ncap = (ncap < node_type::max_leaf_size) ? noadl::min(ncap * 2 + 1, size_type(node_type::max_leaf_size)) : (ncap * 2);
+                }
+                node = this->do_reallocate_leaf(pnode, ncap);
+              }
+              // Append the element to this leaf.
+              allocator_traits<allocator_type>::construct(node->alloc, node->values() + node->nused, ::std::forward<paramsT>(params)...);
+              node->hashes()[node->nused] = hval;
+              node->nused += 1;
+              leaf = node;
+              break;
+            }
+            node = this->do_unshare_node(pnode);
+            const auto ci = node_type::child_index(hval, shift);
+            if(!(node->bmap & (uint32_t(1) << ci))) {
+              // Create a new leaf for this element, then insert it into this branch.
+              leaf = node_type::create(node->alloc, true, 1);
+              try {
+                allocator_traits<allocator_type>::construct(leaf->alloc, leaf->values(), ::std::forward<paramsT>(params)...);
+              } catch(...) {
+                node_type::release(leaf);
+                throw;
+              }
+              leaf->hashes()[0] = hval;
+              leaf->nused = 1;
+              this->do_insert_child(pnode, ci, leaf);
+              break;
+            }
+            pnode = node->children() + node->child_rank(ci);
+            shift += node_type::bits_per_level;
+          }
+          this->m_nelem += 1;
+          return position(leaf, leaf->nused - 1);
+        }
+
+      // Erases the element at `cpos`. The position of the element that follows it is returned.
+      position erase_unchecked(const_position cpos)
+        {
+          ROCKET_ASSERT(cpos.first);
+          ROCKET_ASSERT(cpos.second < cpos.first->nused);
+          const auto hval = cpos.first->hashes()[cpos.second];
+          // If this is the last element in its leaf, locate the first element of the next leaf before the trie is restructured.
+          // N.B. After the leaf is removed, the path of `hval` may lead to a leaf that precedes it in iteration order.
+          const_position cnext(nullptr, 0);
+          if(cpos.second + 1 == cpos.first->nused) {
+            cnext = static_cast<const storage_handle *>(this)->seek(hval, cpos.first->nused);
+          }
+          const auto next_hval = cnext.first ? cnext.first->hashes()[0] : 0;
+          node_type **pnodes[node_type::max_depth + 1];
+          unsigned cis[node_type::max_depth + 1];
+          size_type depth;
+          const auto leaf = this->do_unshare_path(pnodes, cis, depth, hval);
+          // Destroy the element, then move the ones after it backwards, preserving their order.
+          allocator_traits<allocator_type>::destroy(leaf->alloc, leaf->values() + cpos.second);
+          for(auto i = cpos.second + 1; i < leaf->nused; ++i) {
+            allocator_traits<allocator_type>::construct(leaf->alloc, leaf->values() + i - 1, ::std::move(leaf->values()[i]));
+            allocator_traits<allocator_type>::destroy(leaf->alloc, leaf->values() + i);
+            leaf->hashes()[i - 1] = leaf->hashes()[i];
+          }
+          leaf->nused -= 1;
+          this->m_nelem -= 1;
+          const auto leaf_nused = leaf->nused;
+          if(leaf_nused == 0) {
+            // Remove the empty leaf, as well as any branches that become empty.
+            node_type::release(leaf);
+            *(pnodes[depth]) = nullptr;
+            while(depth != 0) {
+              depth -= 1;
+              const auto node = *(pnodes[depth]);
+              const auto rank = node->child_rank(cis[depth]);
+              for(auto i = rank + 1; i < node->nused; ++i) {
+                node->children()[i - 1] = node->children()[i];
+              }
+              node->bmap &= ~(uint32_t(1) << cis[depth]);
+              node->nused -= 1;
+              if(node->nused == 0) {
+                node_type::release(node);
+                *(pnodes[depth]) = nullptr;
+                continue;
+              }
+              if((node->nused == 1) && node->children()[0]->leaf) {
+                // Replace this branch with its only child.
+                *(pnodes[depth]) = node->children()[0];
+                node->nused = 0;
+                node_type::release(node);
+              }
+              break;
+            }
+          }
+          if(cpos.second < leaf_nused) {
+            // The element that followed the erased one has taken its place.
+            return this->seek(hval, cpos.second);
+          }
+          if(!cnext.first) {
+            return position(nullptr, 0);
+          }
+          return this->seek(next_hval, 0);
+        }
+    };
+
+  template<typename hashtrieT, typename valueT>
+    class hashtrie_iterator
+    {
+      template<typename, typename>
+        friend class hashtrie_iterator;
+      friend hashtrieT;
+
+    public:
+      using iterator_category  = ::std::forward_iterator_tag;
+      using value_type         = valueT;
+      using pointer            = value_type *;
+      using reference          = value_type &;
+      using difference_type    = ptrdiff_t;
+
+      using parent_type   = typename copy_const_from<storage_handle<typename hashtrieT::allocator_type, typename hashtrieT::hasher, typename hashtrieT::key_equal>, value_type>::type;
+      using node_type     = typename copy_const_from<typename parent_type::node_type, value_type>::type;
+      using size_type     = typename parent_type::size_type;
+
+    private:
+      parent_type *m_ref;
+      node_type *m_leaf;
+      size_type m_idx;
+
+    private:
+      constexpr hashtrie_iterator(parent_type *ref, pair<node_type *, size_type> pos) noexcept
+        : m_ref(ref), m_leaf(pos.first), m_idx(pos.second)
+        {
+        }
+
+    public:
+      constexpr hashtrie_iterator() noexcept
+        : m_ref(nullptr), m_leaf(nullptr), m_idx(0)
+        {
+        }
+      template<typename yvalueT, typename enable_if<is_convertible<yvalueT *, valueT *>::value>::type * = nullptr>
+        constexpr hashtrie_iterator(const hashtrie_iterator<hashtrieT, yvalueT> &other) noexcept
+          : m_ref(other.m_ref), m_leaf(other.m_leaf), m_idx(other.m_idx)
+        {
+        }
+
+    private:
+      pair<node_type *, size_type> do_assert_valid_position(bool to_dereference) const noexcept
+        {
+          const auto ref = this->m_ref;
+          ROCKET_ASSERT_MSG(ref, "This iterator has not been initialized.");
+          const auto leaf = this->m_leaf;
+          ROCKET_ASSERT_MSG(!(leaf && (this->m_idx >= leaf->nused)), "This iterator has been invalidated.");
+          ROCKET_ASSERT_MSG(!(to_dereference && !leaf), "This iterator contains a past-the-end value and cannot be dereferenced.");
+          return ::std::make_pair(leaf, this->m_idx);
+        }
+
+    public:
+      parent_type * parent() const noexcept
+        {
+          return this->m_ref;
+        }
+
+      pair<node_type *, size_type> tell() const noexcept
+        {
+          return this->do_assert_valid_position(false);
+        }
+      pair<node_type *, size_type> tell_owned_by(const parent_type *ref) const noexcept
+        {
+          ROCKET_ASSERT_MSG(this->m_ref == ref, "This iterator does not refer to an element in the same container.");
+          return this->tell();
+        }
+      hashtrie_iterator & seek_next() noexcept(is_const<parent_type>::value)
+        {
+          const auto pos = this->do_assert_valid_position(false);
+          ROCKET_ASSERT_MSG(pos.first, "The past-the-end iterator cannot be incremented.");
+          if(pos.second + 1 < pos.first->nused) {
+            this->m_idx = pos.second + 1;
+            return *this;
+          }
+          // Move to the next leaf. If this iterator is mutable, the next leaf has to be made unique.
+          const auto next = this->m_ref->seek(pos.first->hashes()[0], pos.first->nused);
+          this->m_leaf = next.first;
+          this->m_idx = next.second;
+          return *this;
+        }
+
+      reference operator*() const noexcept
+        {
+          const auto pos = this->do_assert_valid_position(true);
+          return pos.first->values()[pos.second];
+        }
+      pointer operator->() const noexcept
+        {
+          const auto pos = this->do_assert_valid_position(true);
+          return pos.first->values() + pos.second;
+        }
+    };
+
+  template<typename hashtrieT, typename valueT>
+    inline hashtrie_iterator<hashtrieT, valueT> & operator++(hashtrie_iterator<hashtrieT, valueT> &rhs)
+    {
+      return rhs.seek_next();
+    }
+
+  template<typename hashtrieT, typename valueT>
+    inline hashtrie_iterator<hashtrieT, valueT> operator++(hashtrie_iterator<hashtrieT, valueT> &lhs, int)
+    {
+      auto res = lhs;
+      lhs.seek_next();
+      return res;
+    }
+
+  template<typename hashtrieT, typename xvalueT, typename yvalueT>
+    inline bool operator==(const hashtrie_iterator<hashtrieT, xvalueT> &lhs, const hashtrie_iterator<hashtrieT, yvalueT> &rhs) noexcept
+    {
+      const auto lpos = lhs.tell();
+      const auto rpos = rhs.tell();
+      return (lpos.first == rpos.first) && (lpos.second == rpos.second);
+    }
+  template<typename hashtrieT, typename xvalueT, typename yvalueT>
+    inline bool operator!=(const hashtrie_iterator<hashtrieT, xvalueT> &lhs, const hashtrie_iterator<hashtrieT, yvalueT> &rhs) noexcept
+    {
+      const auto lpos = lhs.tell();
+      const auto rpos = rhs.tell();
+      return (lpos.first != rpos.first) || (lpos.second != rpos.second);
+    }
+
+  }
+
+template<typename keyT, typename mappedT, typename hashT, typename eqT, typename allocatorT>
+  class cow_hashtrie
+  {
+    static_assert(!is_array<keyT>::value, "`keyT` must not be an array type.");
+    static_assert(!is_array<mappedT>::value, "`mappedT` must not be an array type.");
+    static_assert(is_same<typename allocatorT::value_type, pair<const keyT, mappedT>>::value, "`allocatorT::value_type` must denote the same type as `pair<const keyT, mappedT>`.");
+
+  public:
+    // types
+    using key_type        = keyT;
+    using mapped_type     = mappedT;
+    using value_type      = pair<const key_type, mapped_type>;
+    using hasher          = hashT;
+    using key_equal       = eqT;
+    using allocator_type  = allocatorT;
+
+    using size_type        = typename allocator_traits<allocator_type>::size_type;
+    using difference_type  = typename allocator_traits<allocator_type>::difference_type;
+    using const_reference  = const value_type &;
+    using reference        = value_type &;
+
+    using const_iterator          = details_cow_hashtrie::hashtrie_iterator<cow_hashtrie, const value_type>;
+    using iterator                = details_cow_hashtrie::hashtrie_iterator<cow_hashtrie, value_type>;
+
+  private:
+    details_cow_hashtrie::storage_handle<allocator_type, hasher, key_equal> m_sth;
+
+  public:
+    // 26.5.4.2, construct/copy/destroy
+    explicit cow_hashtrie(const allocator_type &alloc) noexcept(is_nothrow_constructible<hasher>::value && is_nothrow_copy_constructible<hasher>::value &&
+                                                                is_nothrow_constructible<key_equal>::value && is_nothrow_copy_constructible<key_equal>::value)
+      : m_sth(alloc, hasher(), key_equal())
+      {
+      }
+    cow_hashtrie() noexcept(is_nothrow_constructible<hasher>::value && is_nothrow_copy_constructible<hasher>::value &&
+                            is_nothrow_constructible<key_equal>::value && is_nothrow_copy_constructible<key_equal>::value &&
+                            is_nothrow_constructible<allocator_type>::value)
+      : cow_hashtrie(allocator_type())
+      {
+      }
+    explicit cow_hashtrie(const hasher &hf, const key_equal &eq = key_equal(), const allocator_type &alloc = allocator_type())
+      : m_sth(alloc, hf, eq)
+      {
+      }
+    cow_hashtrie(const hasher &hf, const allocator_type &alloc)
+      : cow_hashtrie(hf, key_equal(), alloc)
+      {
+      }
+    cow_hashtrie(const cow_hashtrie &other) noexcept(is_nothrow_copy_constructible<hasher>::value && is_nothrow_copy_constructible<key_equal>::value)
+      : cow_hashtrie(other.m_sth.as_hasher(), other.m_sth.as_key_equal(), allocator_traits<allocator_type>::select_on_container_copy_construction(other.m_sth.as_allocator()))
+      {
+        this->assign(other);
+      }
+    cow_hashtrie(const cow_hashtrie &other, const allocator_type &alloc) noexcept(is_nothrow_copy_constructible<hasher>::value && is_nothrow_copy_constructible<key_equal>::value)
+      : cow_hashtrie(other.m_sth.as_hasher(), other.m_sth.as_key_equal(), alloc)
+      {
+        this->assign(other);
+      }
+    cow_hashtrie(cow_hashtrie &&other) noexcept(is_nothrow_copy_constructible<hasher>::value && is_nothrow_copy_constructible<key_equal>::value)
+      : cow_hashtrie(other.m_sth.as_hasher(), other.m_sth.as_key_equal(), allocator_traits<allocator_type>::select_on_container_copy_construction(other.m_sth.as_allocator()))
+      {
+        this->assign(::std::move(other));
+      }
+    cow_hashtrie(cow_hashtrie &&other, const allocator_type &alloc) noexcept(is_nothrow_copy_constructible<hasher>::value && is_nothrow_copy_constructible<key_equal>::value)
+      : cow_hashtrie(other.m_sth.as_hasher(), other.m_sth.as_key_equal(), alloc)
+      {
+        this->assign(::std::move(other));
+      }
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_hashtrie(inputT first, inputT last, const hasher &hf = hasher(), const key_equal &eq = key_equal(), const allocator_type &alloc = allocator_type())
+      : cow_hashtrie(hf, eq, alloc)
+      {
+        this->assign(::std::move(first), ::std::move(last));
+      }
+    cow_hashtrie(initializer_list<value_type> init, const hasher &hf = hasher(), const key_equal &eq = key_equal(), const allocator_type &alloc = allocator_type())
+      : cow_hashtrie(hf, eq, alloc)
+      {
+        this->assign(init);
+      }
+    cow_hashtrie & operator=(const cow_hashtrie &other) noexcept
+      {
+        this->assign(other);
+        allocator_copy_assigner<allocator_type>()(this->m_sth.as_allocator(), other.m_sth.as_allocator());
+        return *this;
+      }
+    cow_hashtrie & operator=(cow_hashtrie &&other) noexcept
+      {
+        this->assign(::std::move(other));
+        allocator_move_assigner<allocator_type>()(this->m_sth.as_allocator(), ::std::move(other.m_sth.as_allocator()));
+        return *this;
+      }
+    cow_hashtrie & operator=(initializer_list<value_type> init)
+      {
+        this->assign(init);
+        return *this;
+      }
+
+  private:
+    template<typename ykeyT, typename ...paramsT>
+      pair<iterator, bool> do_try_emplace(const ykeyT &ykey, const size_t *hval_opt, paramsT &&...params)
+      {
+        const auto hval = hval_opt ? *hval_opt : this->m_sth.as_hasher()(ykey);
+        const auto cpos = this->m_sth.find(ykey, &hval);
+        if(cpos.first) {
+          return ::std::make_pair(iterator(this->m_sth, this->m_sth.unshare(cpos)), false);
+        }
+        const auto pos = this->m_sth.emplace_unchecked(hval, ::std::forward<paramsT>(params)...);
+        return ::std::make_pair(iterator(this->m_sth, pos), true);
+      }
+
+  public:
+    // iterators
+    const_iterator begin() const noexcept
+      {
+        return const_iterator(this->m_sth, this->m_sth.seek(0, 0));
+      }
+    const_iterator end() const noexcept
+      {
+        return const_iterator(this->m_sth, ::std::make_pair(nullptr, 0));
+      }
+
+    const_iterator cbegin() const noexcept
+      {
+        return this->begin();
+      }
+    const_iterator cend() const noexcept
+      {
+        return this->end();
+      }
+
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. This is a non-standard extension.
+    iterator mut_begin()
+      {
+        return iterator(this->m_sth, this->m_sth.seek(0, 0));
+      }
+    // N.B. This is a non-standard extension.
+    iterator mut_end() noexcept
+      {
+        return iterator(this->m_sth, ::std::make_pair(nullptr, 0));
+      }
+
+    // capacity
+    bool empty() const noexcept
+      {
+        return this->m_sth.element_count() == 0;
+      }
+    size_type size() const noexcept
+      {
+        return this->m_sth.element_count();
+      }
+    size_type max_size() const noexcept
+      {
+        return this->m_sth.max_size();
+      }
+    void clear() noexcept
+      {
+        this->m_sth.deallocate();
+      }
+    // N.B. This is a non-standard extension.
+    bool unique() const noexcept
+      {
+        return this->m_sth.unique();
+      }
+    // N.B. This is a non-standard extension.
+    long use_count() const noexcept
+      {
+        return this->m_sth.use_count();
+      }
+    // N.B. This is a non-standard extension.
+    // Returns a pointer that identifies the root of the trie, which is shared by copies of this hashtrie until they are
+    // modified. If this hashtrie is empty, a null pointer is returned.
+    const void * root_id() const noexcept
+      {
+        return this->m_sth.root_id();
+      }
+    // N.B. This is a non-standard extension.
+    // Returns `true` if a node other than the root is shared with another hashtrie, which happens when one that shared
+    // the root with this hashtrie has been modified.
+    bool has_shared_subtrees() const noexcept
+      {
+        return this->m_sth.has_shared_subtrees();
+      }
+
+    // 26.5.4.4, modifiers
+    pair<iterator, bool> insert(const value_type &value)
+      {
+        return this->try_emplace(value.first, value.second);
+      }
+    pair<iterator, bool> insert(value_type &&value)
+      {
+        return this->try_emplace(value.first, ::std::move(value.second));
+      }
+    // N.B. This is a non-standard extension.
+    template<typename ykeyT, typename yvalueT>
+      pair<iterator, bool> insert(const pair<ykeyT, yvalueT> &value)
+      {
+        return this->try_emplace(value.first, value.second);
+      }
+    // N.B. This is a non-standard extension.
+    template<typename ykeyT, typename yvalueT>
+      pair<iterator, bool> insert(pair<ykeyT, yvalueT> &&value)
+      {
+        return this->try_emplace(::std::move(value.first), ::std::move(value.second));
+      }
+    // N.B. The return type is a non-standard extension.
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_hashtrie & insert(inputT first, inputT last)
+      {
+        if(first == last) {
+          return *this;
+        }
+        noadl::ranged_do_while(::std::move(first), ::std::move(last), [&](const inputT &it) { this->insert(*it); });
+        return *this;
+      }
+    // N.B. The return type is a non-standard extension.
+    cow_hashtrie & insert(initializer_list<value_type> init)
+      {
+        return this->insert(init.begin(), init.end());
+      }
+    // N.B. The hint is ignored.
+    iterator insert(const_iterator /*hint*/, const value_type &value)
+      {
+        return this->insert(value).first;
+      }
+    // N.B. The hint is ignored.
+    iterator insert(const_iterator /*hint*/, value_type &&value)
+      {
+        return this->insert(::std::move(value)).first;
+      }
+
+    template<typename ...paramsT>
+      pair<iterator, bool> try_emplace(const key_type &key, paramsT &&...params)
+      {
+        return this->do_try_emplace(key, nullptr, ::std::piecewise_construct,
+                                    ::std::forward_as_tuple(key), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
+      }
+    template<typename ...paramsT>
+      pair<iterator, bool> try_emplace(key_type &&key, paramsT &&...params)
+      {
+        return this->do_try_emplace(key, nullptr, ::std::piecewise_construct,
+                                    ::std::forward_as_tuple(::std::move(key)), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
+      }
+    // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    template<typename ...paramsT>
+      pair<iterator, bool> try_emplace_with_hash(const key_type &key, size_t hval, paramsT &&...params)
+      {
+        return this->do_try_emplace(key, &hval, ::std::piecewise_construct,
+                                    ::std::forward_as_tuple(key), ::std::forward_as_tuple(::std::forward<paramsT>(params)...));
+      }
+    // N.B. The hint is ignored.
+    template<typename ...paramsT>
+      iterator try_emplace(const_iterator /*hint*/, const key_type &key, paramsT &&...params)
+      {
+        return this->try_emplace(key, ::std::forward<paramsT>(params)...).first;
+      }
+    // N.B. The hint is ignored.
+    template<typename ...paramsT>
+      iterator try_emplace(const_iterator /*hint*/, key_type &&key, paramsT &&...params)
+      {
+        return this->try_emplace(::std::move(key), ::std::forward<paramsT>(params)...).first;
+      }
+
+    template<typename yvalueT>
+      pair<iterator, bool> insert_or_assign(const key_type &key, yvalueT &&yvalue)
+      {
+        const auto result = this->do_try_emplace(key, nullptr, key, ::std::forward<yvalueT>(yvalue));
+        if(!result.second) {
+          result.first->second = ::std::forward<yvalueT>(yvalue);
+        }
+        return result;
+      }
+    template<typename yvalueT>
+      pair<iterator, bool> insert_or_assign(key_type &&key, yvalueT &&yvalue)
+      {
+        const auto result = this->do_try_emplace(key, nullptr, ::std::move(key), ::std::forward<yvalueT>(yvalue));
+        if(!result.second) {
+          result.first->second = ::std::forward<yvalueT>(yvalue);
+        }
+        return result;
+      }
+    // N.B. The hint is ignored.
+    template<typename yvalueT>
+      iterator insert_or_assign(const_iterator /*hint*/, const key_type &key, yvalueT &&yvalue)
+      {
+        return this->insert_or_assign(key, ::std::forward<yvalueT>(yvalue)).first;
+      }
+    // N.B. The hint is ignored.
+    template<typename yvalueT>
+      iterator insert_or_assign(const_iterator /*hint*/, key_type &&key, yvalueT &&yvalue)
+      {
+        return this->insert_or_assign(::std::move(key), ::std::forward<yvalueT>(yvalue)).first;
+      }
+
+    // N.B. This function may throw `std::bad_alloc`.
+    iterator erase(const_iterator tfirst)
+      {
+        const auto cpos = tfirst.tell_owned_by(this->m_sth);
+        return iterator(this->m_sth, this->m_sth.erase_unchecked(cpos));
+      }
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. The return type differs from `std::unordered_map`.
+    template<typename ykeyT, typename enable_if<!(is_convertible<ykeyT, const_iterator>::value)>::type * = nullptr>
+      bool erase(const ykeyT &key)
+      {
+        const auto cpos = this->m_sth.find(key);
+        if(!cpos.first) {
+          return false;
+        }
+        this->m_sth.erase_unchecked(cpos);
+        return true;
+      }
+
+    // map operations
+    const_iterator find(const key_type &key) const
+      {
+        return const_iterator(this->m_sth, this->m_sth.find(key));
+      }
+    // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    const_iterator find(const key_type &key, size_t hval) const
+      {
+        return const_iterator(this->m_sth, this->m_sth.find(key, &hval));
+      }
+
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. This is a non-standard extension.
+    iterator find_mut(const key_type &key)
+      {
+        return iterator(this->m_sth, this->m_sth.unshare(this->m_sth.find(key)));
+      }
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. This is a non-standard extension.
+    // `hval` shall be the hash value of `key`, as if it was computed by `hash_function()(key)`.
+    iterator find_mut(const key_type &key, size_t hval)
+      {
+        return iterator(this->m_sth, this->m_sth.unshare(this->m_sth.find(key, &hval)));
+      }
+
+    size_t count(const key_type &key) const
+      {
+        const auto cpos = this->m_sth.find(key);
+        if(!cpos.first) {
+          return 0;
+        }
+        return 1;
+      }
+
+    // 26.5.4.3, element access
+    const mapped_type & at(const key_type &key) const
+      {
+        const auto cpos = this->m_sth.find(key);
+        if(!cpos.first) {
+          noadl::throw_out_of_range("cow_hashtrie: The specified key does not exist in this hashtrie.");
+        }
+        return cpos.first->values()[cpos.second].second;
+      }
+
+    // N.B. This is a non-standard extension.
+    mapped_type & mut(const key_type &key)
+      {
+        const auto cpos = this->m_sth.find(key);
+        if(!cpos.first) {
+          noadl::throw_out_of_range("cow_hashtrie: The specified key does not exist in this hashtrie.");
+        }
+        const auto pos = this->m_sth.unshare(cpos);
+        return pos.first->values()[pos.second].second;
+      }
+    mapped_type & operator[](const key_type &key)
+      {
+        return this->try_emplace(key).first->second;
+      }
+    mapped_type & operator[](key_type &&key)
+      {
+        return this->try_emplace(::std::move(key)).first->second;
+      }
+
+    // N.B. This function is a non-standard extension.
+    cow_hashtrie & assign(const cow_hashtrie &other) noexcept
+      {
+        this->m_sth.share_with(other.m_sth);
+        return *this;
+      }
+    // N.B. This function is a non-standard extension.
+    cow_hashtrie & assign(cow_hashtrie &&other) noexcept
+      {
+        this->m_sth.share_with(::std::move(other.m_sth));
+        return *this;
+      }
+    // N.B. This function is a non-standard extension.
+    cow_hashtrie & assign(initializer_list<value_type> init)
+      {
+        this->clear();
+        this->insert(init);
+        return *this;
+      }
+    // N.B. This function is a non-standard extension.
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_hashtrie & assign(inputT first, inputT last)
+      {
+        this->clear();
+        this->insert(::std::move(first), ::std::move(last));
+        return *this;
+      }
+
+    void swap(cow_hashtrie &other) noexcept
+      {
+        this->m_sth.exchange_with(other.m_sth);
+        allocator_swapper<allocator_type>()(this->m_sth.as_allocator(), other.m_sth.as_allocator());
+      }
+
+    // N.B. The return type differs from `std::unordered_map`.
+    const allocator_type & get_allocator() const noexcept
+      {
+        return this->m_sth.as_allocator();
+      }
+    allocator_type & get_allocator() noexcept
+      {
+        return this->m_sth.as_allocator();
+      }
+    // N.B. The return type differs from `std::unordered_map`.
+    const hasher & hash_function() const noexcept
+      {
+        return this->m_sth.as_hasher();
+      }
+    hasher & hash_function() noexcept
+      {
+        return this->m_sth.as_hasher();
+      }
+    // N.B. The return type differs from `std::unordered_map`.
+    const key_equal & key_eq() const noexcept
+      {
+        return this->m_sth.as_key_equal();
+      }
+    key_equal & key_eq() noexcept
+      {
+        return this->m_sth.as_key_equal();
+      }
+  };
+
+template<typename keyT, typename mappedT, typename hashT, typename eqT, typename allocatorT>
+  inline void swap(cow_hashtrie<keyT, mappedT, hashT, eqT, allocatorT> &lhs, cow_hashtrie<keyT, mappedT, hashT, eqT, allocatorT> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+}
+
+#endif
@@ -0,0 +1,1478 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ROCKET_COW_RRBVECTOR_HPP_
+#define ROCKET_COW_RRBVECTOR_HPP_
+
+#include <memory> // std::allocator<>, std::allocator_traits<>, std::pointer_traits<>
+#include <atomic> // std::atomic<>
+#include <type_traits> // so many...
+#include <iterator> // std::iterator_traits<>, std::reverse_iterator<>, std::random_access_iterator_tag
+#include <initializer_list> // std::initializer_list<>
+#include <utility> // std::move(), std::forward()
+#include <typeinfo> // typeid()
+#include <limits> // std::numeric_limits<>
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <cstring> // std::memset()
+#include "compatibility.h"
+#include "assert.hpp"
+#include "throw.hpp"
+#include "utilities.hpp"
+#include "allocator_utilities.hpp"
+
+/* Differences from `std::vector`:
+ * 1. All functions guarantee only basic exception safety rather than strong exception safety, hence are more efficient.
+ * 2. `begin()` and `end()` always return `const_iterator`s. `at()`, `front()` and `back()` always return `const_reference`s.
+ * 3. The copy constructor and copy assignment operator will not throw exceptions.
+ * 4. The specialization for `bool` is not provided.
+ * 5. `emplace()` is not provided.
+ * 6. Comparison operators are not provided.
+ * 7. The value type may be incomplete. It need be neither copy-assignable nor move-assignable, but must be swappable.
+ * 8. Elements are not contiguous. `data()` is not provided. Mutable iterators are not provided; `mut()` is recommended as an alternative.
+ * 9. Elements are stored in a relaxed radix balanced tree, whose nodes are shared and copied individually. Modifying a shared vector copies only nodes on the path to the element being modified.
+ * 10. A vector that has no more than 32 elements consists of a single leaf.
+ */
+
+namespace rocket {
+
+using ::std::allocator;
+using ::std::allocator_traits;
+using ::std::atomic;
+using ::std::is_same;
+using ::std::is_array;
+using ::std::enable_if;
+using ::std::is_convertible;
+using ::std::is_copy_constructible;
+using ::std::is_nothrow_constructible;
+using ::std::is_nothrow_move_constructible;
+using ::std::iterator_traits;
+using ::std::initializer_list;
+using ::std::pair;
+using ::std::size_t;
+using ::std::ptrdiff_t;
+
+template<typename valueT, typename allocatorT = allocator<valueT>>
+  class cow_rrbvector;
+
+  namespace details_cow_rrbvector {
+
+  template<typename allocatorT>
+    struct rrb_node
+    {
+      using allocator_type   = allocatorT;
+      using value_type       = typename allocator_type::value_type;
+      using size_type        = typename allocator_traits<allocator_type>::size_type;
+      using node_allocator   = typename allocator_traits<allocator_type>::template rebind_alloc<rrb_node>;
+      using node_pointer     = typename allocator_traits<node_allocator>::pointer;
+
+      // Each node has up to 32 children or elements. A node of height `h` has up to `32 ^ (h + 1)` elements.
+      // Leaves have a height of zero. All leaves have the same depth.
+      enum : size_type { bits_per_level = 5, max_node_size = 32 };
+      enum : size_type { max_depth = (::std::numeric_limits<size_type>::digits + bits_per_level - 1) / bits_per_level };
+
+      static constexpr size_type min_nblk_for_leaf(size_type ncap) noexcept
+        {
+          return (ncap * sizeof(value_type) + sizeof(rrb_node) - 1) / sizeof(rrb_node) + 1;
+        }
+      // Each child of a branch comes with a cumulative size, so subtrees need not be full.
+      static constexpr size_type min_nblk_for_branch(size_type ncap) noexcept
+        {
+          return (ncap * (sizeof(size_type) + sizeof(rrb_node *)) + sizeof(rrb_node) - 1) / sizeof(rrb_node) + 1;
+        }
+
+      atomic<long> nref;
+      allocator_type alloc;
+      size_type nblk;
+      size_type height;
+      size_type nused;
+      size_type ncap;
+
+      rrb_node(const allocator_type &xalloc, size_type xnblk, size_type xheight, size_type xncap) noexcept
+        : alloc(xalloc), nblk(xnblk), height(xheight), nused(0), ncap(xncap)
+        {
+          this->nref.store(1, ::std::memory_order_release);
+        }
+      ~rrb_node()
+        {
+          if(this->height == 0) {
+            for(size_type i = 0; i < this->nused; ++i) {
+              allocator_traits<allocator_type>::destroy(this->alloc, this->values() + i);
+            }
+          } else {
+            for(size_type i = 0; i < this->nused; ++i) {
+              release(this->children()[i]);
+            }
+          }
+#ifdef ROCKET_DEBUG
+          this->nused = 0xEECD;
+#endif
+        }
+
+      rrb_node(const rrb_node &)
+        = delete;
+      rrb_node & operator=(const rrb_node &)
+        = delete;
+
+      // Allocates a node. Its reference count is initialized to one.
+      static rrb_node * create(const allocator_type &alloc, size_type height, size_type ncap)
+        {
+          static_assert(alignof(value_type) <= alignof(rrb_node), "`value_type` is over-aligned.");
+          const auto nblk = (height == 0) ? min_nblk_for_leaf(ncap) : min_nblk_for_branch(ncap);
+          auto nd_alloc = node_allocator(alloc);
+          const auto ptr = noadl::unfancy(allocator_traits<node_allocator>::allocate(nd_alloc, nblk));
+#ifdef ROCKET_DEBUG
+          ::std::memset(static_cast<void *>(ptr), '*', sizeof(rrb_node) * nblk);
+#endif
+          return noadl::construct_at(ptr, alloc, nblk, height, ncap);
+        }
+      // Decrements the reference count of a node and deallocates it if the reference count reaches zero.
+      static void release(rrb_node *ptr) noexcept
+        {
+          // Decrement the reference count with acquire-release semantics to prevent races on `ptr->alloc`.
+          const auto nref_old = ptr->nref.fetch_sub(1, ::std::memory_order_acq_rel);
+          if(nref_old > 1) {
+            return;
+          }
+          ROCKET_ASSERT(nref_old == 1);
+          auto nd_alloc = node_allocator(ptr->alloc);
+          const auto nblk = ptr->nblk;
+          const auto fptr = ::std::pointer_traits<node_pointer>::pointer_to(*ptr);
+          noadl::destroy_at(ptr);
+#ifdef ROCKET_DEBUG
+          ::std::memset(static_cast<void *>(ptr), '~', sizeof(rrb_node) * nblk);
+#endif
+          allocator_traits<node_allocator>::deallocate(nd_alloc, fptr, nblk);
+        }
+
+      bool unique() const noexcept
+        {
+          return this->nref.load(::std::memory_order_relaxed) == 1;
+        }
+      long use_count() const noexcept
+        {
+          return this->nref.load(::std::memory_order_relaxed);
+        }
+      // Returns `true` if a node below this one is shared, which is possible even if this node is not.
+      bool has_shared_descendants() const noexcept
+        {
+          if(this->height == 0) {
+            return false;
+          }
+          for(size_type i = 0; i < this->nused; ++i) {
+            const auto child = this->children()[i];
+            if(!child->unique() || child->has_shared_descendants()) {
+              return true;
+            }
+          }
+          return false;
+        }
+      void add_ref() noexcept
+        {
+          const auto nref_old = this->nref.fetch_add(1, ::std::memory_order_relaxed);
+          ROCKET_ASSERT(nref_old >= 1);
+        }
+
+      const value_type * values() const noexcept
+        {
+          ROCKET_ASSERT(this->height == 0);
+          return reinterpret_cast<const value_type *>(this + 1);
+        }
+      value_type * values() noexcept
+        {
+          ROCKET_ASSERT(this->height == 0);
+          return reinterpret_cast<value_type *>(this + 1);
+        }
+      // The `j`-th size is the number of elements in the first `j + 1` children.
+      const size_type * sizes() const noexcept
+        {
+          ROCKET_ASSERT(this->height != 0);
+          return reinterpret_cast<const size_type *>(this + 1);
+        }
+      size_type * sizes() noexcept
+        {
+          ROCKET_ASSERT(this->height != 0);
+          return reinterpret_cast<size_type *>(this + 1);
+        }
+      rrb_node * const * children() const noexcept
+        {
+          return reinterpret_cast<rrb_node * const *>(this->sizes() + this->ncap);
+        }
+      rrb_node ** children() noexcept
+        {
+          return reinterpret_cast<rrb_node **>(this->sizes() + this->ncap);
+        }
+
+      size_type count() const noexcept
+        {
+          if(this->height == 0) {
+            return this->nused;
+          }
+          if(this->nused == 0) {
+            return 0;
+          }
+          return this->sizes()[this->nused - 1];
+        }
+      // Returns the number of elements in children before the `j`-th one.
+      size_type child_offset(size_type j) const noexcept
+        {
+          ROCKET_ASSERT(j <= this->nused);
+          return (j == 0) ? 0 : this->sizes()[j - 1];
+        }
+      // Returns the index of the child which contains the `idx`-th element. If `idx` equals `count()`, the last child is returned.
+      size_type find_child(size_type idx) const noexcept
+        {
+          ROCKET_ASSERT(this->nused != 0);
+          // Make a guess as if all children were full, which never goes past the target, then search forwards using cumulative sizes.
+          const auto shift = this->height * bits_per_level;
+          auto j = (shift < ::std::numeric_limits<size_type>::digits) ? noadl::min(idx >> shift, this->nused - 1) : 0;
+          while((j + 1 < this->nused) && (this->sizes()[j] <= idx)) {
+            ++j;
+          }
+          return j;
+        }
+      // Recalculates cumulative sizes of children from the `j`-th one.
+      void update_sizes(size_type j) noexcept
+        {
+          auto sum = this->child_offset(j);
+          for(auto k = j; k < this->nused; ++k) {
+            sum += this->children()[k]->count();
+            this->sizes()[k] = sum;
+          }
+        }
+    };
+
+  template<typename allocatorT, bool copyableT = is_copy_constructible<typename allocatorT::value_type>::value>
+    struct copy_element_helper
+    {
+      // This is the generic version.
+      void operator()(allocatorT &alloc, typename allocatorT::value_type *ptr, const typename allocatorT::value_type &src) const
+        {
+          allocator_traits<allocatorT>::construct(alloc, ptr, src);
+        }
+    };
+  template<typename allocatorT>
+    struct copy_element_helper<allocatorT, false>
+    {
+      // This specialization is used when `allocatorT::value_type` is not copy-constructible.
+      [[noreturn]] void operator()(allocatorT & /*alloc*/, typename allocatorT::value_type * /*ptr*/, const typename allocatorT::value_type & /*src*/) const
+        {
+          // `allocatorT::value_type` is not copy-constructible.
+          noadl::throw_domain_error("cow_rrbvector: `%s` is not copy-constructible.", typeid(typename allocatorT::value_type).name());
+        }
+    };
+
+  // Constructs an element in `dst` from `src`. If `to_move` is `true` and no exception would be thrown, the element is moved, otherwise it is copied.
+  template<typename allocatorT>
+    inline void transfer_element(allocatorT &alloc, typename allocatorT::value_type *dst, typename allocatorT::value_type &src, bool to_move)
+    {
+      if(is_nothrow_move_constructible<typename allocatorT::value_type>::value && to_move) {
+        allocator_traits<allocatorT>::construct(alloc, dst, ::std::move(src));
+        return;
+      }
+      copy_element_helper<allocatorT>()(alloc, dst, src);
+    }
+
+  template<typename allocatorT>
+    class storage_handle : private allocator_wrapper_base_for<allocatorT>::type
+    {
+    public:
+      using allocator_type   = allocatorT;
+      using value_type       = typename allocator_type::value_type;
+      using node_type        = rrb_node<allocator_type>;
+      using size_type        = typename allocator_traits<allocator_type>::size_type;
+      using difference_type  = typename allocator_traits<allocator_type>::difference_type;
+
+    private:
+      using allocator_base    = typename allocator_wrapper_base_for<allocator_type>::type;
+
+    private:
+      node_type *m_root;
+
+    public:
+      explicit constexpr storage_handle(const allocator_type &alloc)
+        : allocator_base(alloc),
+          m_root()
+        {
+        }
+      explicit constexpr storage_handle(allocator_type &&alloc)
+        : allocator_base(::std::move(alloc)),
+          m_root()
+        {
+        }
+      ~storage_handle()
+        {
+          this->deallocate();
+        }
+
+      storage_handle(const storage_handle &)
+        = delete;
+      storage_handle & operator=(const storage_handle &)
+        = delete;
+
+    private:
+      // Makes the node `*pnode` owned exclusively by its parent, copying it if it is shared.
+      node_type * do_unshare_node(node_type **pnode)
+        {
+          const auto node = *pnode;
+          ROCKET_ASSERT(node);
+          if(node->unique()) {
+            return node;
+          }
+          const auto node_new = node_type::create(node->alloc, node->height, node->ncap);
+          if(node->height == 0) {
+            try {
+              for(size_type i = 0; i < node->nused; ++i) {
+                copy_element_helper<allocator_type>()(node_new->alloc, node_new->values() + i, node->values()[i]);
+                node_new->nused = i + 1;
+              }
+            } catch(...) {
+              node_type::release(node_new);
+              throw;
+            }
+          } else {
+            // Share all children.
+            for(size_type i = 0; i < node->nused; ++i) {
+              const auto child = node->children()[i];
+              child->add_ref();
+              node_new->children()[i] = child;
+              node_new->sizes()[i] = node->sizes()[i];
+            }
+            node_new->nused = node->nused;
+          }
+          *pnode = node_new;
+          node_type::release(node);
+          return node_new;
+        }
+      // Replaces the leaf `*pnode` with a new one which has room for `ncap` elements. Existing elements are moved if the old leaf is not shared.
+      node_type * do_reallocate_leaf(node_type **pnode, size_type ncap)
+        {
+          const auto node = *pnode;
+          ROCKET_ASSERT(node && (node->height == 0));
+          ROCKET_ASSERT(ncap >= node->nused);
+          const auto node_new = node_type::create(node->alloc, 0, ncap);
+          const bool to_move = node->unique();
+          try {
+            for(size_type i = 0; i < node->nused; ++i) {
+              transfer_element(node_new->alloc, node_new->values() + i, node->values()[i], to_move);
+              node_new->nused = i + 1;
+            }
+          } catch(...) {
+            node_type::release(node_new);
+            throw;
+          }
+          *pnode = node_new;
+          node_type::release(node);
+          return node_new;
+        }
+      // Moves or copies children or elements `[from, node->nused)` of `node` to the end of `dst`. `node` is not modified.
+      void do_transfer_tail(node_type *dst, node_type *node, size_type from)
+        {
+          ROCKET_ASSERT(dst->height == node->height);
+          ROCKET_ASSERT(dst->ncap - dst->nused >= node->nused - from);
+          const bool to_move = node->unique();
+          if(node->height == 0) {
+            const auto nused_old = dst->nused;
+            try {
+              for(auto i = from; i < node->nused; ++i) {
+                transfer_element(dst->alloc, dst->values() + dst->nused, node->values()[i], to_move);
+                dst->nused += 1;
+              }
+            } catch(...) {
+              // Roll back.
+              while(dst->nused != nused_old) {
+                dst->nused -= 1;
+                allocator_traits<allocator_type>::destroy(dst->alloc, dst->values() + dst->nused);
+              }
+              throw;
+            }
+          } else {
+            const auto nused_old = dst->nused;
+            for(auto i = from; i < node->nused; ++i) {
+              const auto child = node->children()[i];
+              // If `node` is unique, its reference will be dropped by the caller.
+              child->add_ref();
+              dst->children()[dst->nused] = child;
+              dst->nused += 1;
+            }
+            dst->update_sizes(nused_old);
+          }
+        }
+      // Truncates the node `*pnode` to its first `n` children or elements, copying it if it is shared.
+      node_type * do_truncate_node(node_type **pnode, size_type n)
+        {
+          const auto node = *pnode;
+          if(!node->unique()) {
+            const auto node_new = node_type::create(node->alloc, node->height, node_type::max_node_size);
+            try {
+              this->do_transfer_tail(node_new, node, 0);
+            } catch(...) {
+              node_type::release(node_new);
+              throw;
+            }
+            *pnode = node_new;
+            node_type::release(node);
+          }
+          const auto node_new = *pnode;
+          while(node_new->nused > n) {
+            node_new->nused -= 1;
+            if(node_new->height == 0) {
+              allocator_traits<allocator_type>::destroy(node_new->alloc, node_new->values() + node_new->nused);
+            } else {
+              node_type::release(node_new->children()[node_new->nused]);
+            }
+          }
+          return node_new;
+        }
+      // Splits the `j`-th child of `parent` before its `at`-th child or element. `parent` must not be shared or full.
+      void do_split_child(node_type *parent, size_type j, size_type at)
+        {
+          ROCKET_ASSERT(parent->unique());
+          ROCKET_ASSERT(parent->nused < parent->ncap);
+          const auto child = parent->children()[j];
+          ROCKET_ASSERT((0 < at) && (at < child->nused));
+          // Create the right half.
+          const auto right = node_type::create(child->alloc, child->height, node_type::max_node_size);
+          try {
+            this->do_transfer_tail(right, child, at);
+            // Truncate the left half.
+            this->do_truncate_node(parent->children() + j, at);
+          } catch(...) {
+            node_type::release(right);
+            throw;
+          }
+          // Insert the right half after the left half.
+          for(auto k = parent->nused; k != j + 1; --k) {
+            parent->children()[k] = parent->children()[k - 1];
+          }
+          parent->children()[j + 1] = right;
+          parent->nused += 1;
+          parent->update_sizes(j);
+        }
+      // Returns where to split a full node on the path of an insertion of the `idx`-th element into a vector of `cnt` elements.
+      // If the element is to be inserted at either end, the other half of the node is left full, so repeated appending and
+      // prepending both leave full nodes behind, and insertion at either end is amortized constant time apart from descending.
+      static size_type do_get_split_point(size_type idx, size_type cnt) noexcept
+        {
+          if(idx == cnt) {
+            return node_type::max_node_size - 1;
+          }
+          if(idx == 0) {
+            return 1;
+          }
+          return node_type::max_node_size / 2;
+        }
+      // Merges the `j + 1`-th child of `parent` into the `j`-th one. `parent` must not be shared.
+      void do_merge_children(node_type *parent, size_type j)
+        {
+          ROCKET_ASSERT(parent->unique());
+          ROCKET_ASSERT(j + 1 < parent->nused);
+          const auto right = parent->children()[j + 1];
+          auto left = this->do_unshare_node(parent->children() + j);
+          ROCKET_ASSERT(left->nused + right->nused <= node_type::max_node_size);
+          if(left->ncap - left->nused < right->nused) {
+            left = this->do_reallocate_leaf(parent->children() + j, node_type::max_node_size);
+          }
+          this->do_transfer_tail(left, right, 0);
+          // Remove the right child.
+          node_type::release(right);
+          for(auto k = j + 1; k + 1 < parent->nused; ++k) {
+            parent->children()[k] = parent->children()[k + 1];
+          }
+          parent->nused -= 1;
+          parent->update_sizes(j);
+        }
+      // Creates a new subtree that has elements `[from, to)` of `node`. Unmodified children are shared.
+      node_type * do_slice(const node_type *node, size_type from, size_type to) const
+        {
+          ROCKET_ASSERT(from < to);
+          ROCKET_ASSERT(to <= node->count());
+          if(node->height == 0) {
+            const auto res = node_type::create(node->alloc, 0, to - from);
+            try {
+              for(auto i = from; i < to; ++i) {
+                copy_element_helper<allocator_type>()(res->alloc, res->values() + res->nused, node->values()[i]);
+                res->nused += 1;
+              }
+            } catch(...) {
+              node_type::release(res);
+              throw;
+            }
+            return res;
+          }
+          const auto res = node_type::create(node->alloc, node->height, node_type::max_node_size);
+          try {
+            for(auto j = node->find_child(from); j < node->nused; ++j) {
+              const auto off = node->child_offset(j);
+              if(off >= to) {
+                break;
+              }
+              const auto child = node->children()[j];
+              const auto cnt = child->count();
+              const auto sub_from = noadl::max(from, off) - off;
+              const auto sub_to = noadl::min(to, off + cnt) - off;
+              if((sub_from == 0) && (sub_to == cnt)) {
+                // Share this child.
+                child->add_ref();
+                res->children()[res->nused] = child;
+              } else {
+                res->children()[res->nused] = this->do_slice(child, sub_from, sub_to);
+              }
+              res->nused += 1;
+            }
+          } catch(...) {
+            node_type::release(res);
+            throw;
+          }
+          res->update_sizes(0);
+          return res;
+        }
+      // Replaces the root with its only child as long as possible.
+      void do_collapse_root() noexcept
+        {
+          for(;;) {
+            const auto root = this->m_root;
+            if(!root) {
+              break;
+            }
+            if(root->nused == 0) {
+              node_type::release(root);
+              this->m_root = nullptr;
+              break;
+            }
+            if((root->height == 0) || (root->nused != 1)) {
+              break;
+            }
+            // Transfer the child.
+            this->m_root = root->children()[0];
+            root->nused = 0;
+            node_type::release(root);
+          }
+        }
+
+    public:
+      const allocator_type & as_allocator() const noexcept
+        {
+          return static_cast<const allocator_base &>(*this);
+        }
+      allocator_type & as_allocator() noexcept
+        {
+          return static_cast<allocator_base &>(*this);
+        }
+
+      bool unique() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return false;
+          }
+          return root->unique();
+        }
+      long use_count() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return 0;
+          }
+          return root->use_count();
+        }
+      const void * root_id() const noexcept
+        {
+          return this->m_root;
+        }
+      bool has_shared_subtrees() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return false;
+          }
+          return root->has_shared_descendants();
+        }
+      size_type size() const noexcept
+        {
+          const auto root = this->m_root;
+          if(!root) {
+            return 0;
+          }
+          return root->count();
+        }
+      size_type max_size() const noexcept
+        {
+          auto nd_alloc = typename node_type::node_allocator(this->as_allocator());
+          const auto max_nblk = allocator_traits<typename node_type::node_allocator>::max_size(nd_alloc);
+          return max_nblk / 2 * sizeof(node_type) / sizeof(value_type);
+        }
+      size_type check_size_add(size_type base, size_type add) const
+        {
+          const auto cap_max = this->max_size();
+          ROCKET_ASSERT(base <= cap_max);
+          if(cap_max - base < add) {
+            noadl::throw_length_error("cow_rrbvector: Increasing `%lld` by `%lld` would exceed the max size `%lld`.",
+                                      static_cast<long long>(base), static_cast<long long>(add), static_cast<long long>(cap_max));
+          }
+          return base + add;
+        }
+      // Makes sure a vector that has no more than `max_node_size` elements can hold `res_arg` elements without reallocation.
+      void reserve_leaf(size_type res_arg)
+        {
+          if(res_arg > node_type::max_node_size) {
+            return;
+          }
+          const auto root = this->m_root;
+          if(!root) {
+            this->m_root = node_type::create(this->as_allocator(), 0, res_arg);
+            return;
+          }
+          if((root->height != 0) || (root->unique() && (root->ncap >= res_arg))) {
+            return;
+          }
+          this->do_reallocate_leaf(&(this->m_root), noadl::max(root->nused, res_arg));
+        }
+
+      void deallocate() noexcept
+        {
+          const auto root = noadl::exchange(this->m_root, nullptr);
+          if(!root) {
+            return;
+          }
+          node_type::release(root);
+        }
+
+      void share_with(const storage_handle &other) noexcept
+        {
+          const auto root = other.m_root;
+          if(root) {
+            // Increment the reference count.
+            root->add_ref();
+          }
+          this->deallocate();
+          this->m_root = root;
+        }
+      void share_with(storage_handle &&other) noexcept
+        {
+          // Detach the tree.
+          const auto root = noadl::exchange(other.m_root, nullptr);
+          this->deallocate();
+          this->m_root = root;
+        }
+      void exchange_with(storage_handle &other) noexcept
+        {
+          ::std::swap(this->m_root, other.m_root);
+        }
+      // Replaces the contents of this vector with elements `[tpos, tpos + tn)` of `other`.
+      void slice_from(const storage_handle &other, size_type tpos, size_type tn)
+        {
+          ROCKET_ASSERT(tpos <= other.size());
+          ROCKET_ASSERT(tn <= other.size() - tpos);
+          if(tn == 0) {
+            this->deallocate();
+            return;
+          }
+          const auto root = this->do_slice(other.m_root, tpos, tpos + tn);
+          this->deallocate();
+          this->m_root = root;
+          this->do_collapse_root();
+        }
+
+      constexpr operator const storage_handle * () const noexcept
+        {
+          return this;
+        }
+      operator storage_handle * () noexcept
+        {
+          return this;
+        }
+
+      // Returns the leaf that contains the `idx`-th element, and the offset of that element in the leaf.
+      pair<const node_type *, size_type> locate(size_type idx) const noexcept
+        {
+          ROCKET_ASSERT(idx < this->size());
+          auto node = static_cast<const node_type *>(this->m_root);
+          while(node->height != 0) {
+            const auto j = node->find_child(idx);
+            idx -= node->child_offset(j);
+            node = node->children()[j];
+          }
+          return ::std::make_pair(node, idx);
+        }
+      // Returns a pointer to the `idx`-th element, making all nodes on its path owned exclusively by this vector.
+      value_type * mut_element(size_type idx)
+        {
+          ROCKET_ASSERT(idx < this->size());
+          auto pnode = &(this->m_root);
+          for(;;) {
+            const auto node = this->do_unshare_node(pnode);
+            if(node->height == 0) {
+              break;
+            }
+            const auto j = node->find_child(idx);
+            idx -= node->child_offset(j);
+            pnode = node->children() + j;
+          }
+          return (*pnode)->values() + idx;
+        }
+
+      template<typename ...paramsT>
+        value_type * insert_unchecked(size_type idx, paramsT &&...params)
+        {
+          const auto cnt = this->size();
+          ROCKET_ASSERT(idx <= cnt);
+          this->check_size_add(cnt, 1);
+          if(!this->m_root) {
+            this->m_root = node_type::create(this->as_allocator(), 0, 1);
+          }
+          if(this->m_root->nused == node_type::max_node_size) {
+            // Add a new root above the full one, then split it.
+            const auto root = node_type::create(this->as_allocator(), this->m_root->height + 1, node_type::max_node_size);
+            root->children()[0] = this->m_root;
+            root->nused = 1;
+            root->update_sizes(0);
+            this->m_root = root;
+            this->do_split_child(root, 0, this->do_get_split_point(idx, cnt));
+          }
+          // Descend to the leaf, splitting full nodes on the way, so that there will be room for the new element.
+          node_type *parents[node_type::max_depth];
+          size_type js[node_type::max_depth];
+          size_type depth = 0;
+          auto pnode = &(this->m_root);
+          auto off = idx;
+          for(;;) {
+            const auto node = this->do_unshare_node(pnode);
+            if(node->height == 0) {
+              break;
+            }
+            auto j = node->find_child(off);
+            const auto child = node->children()[j];
+            if(child->nused == node_type::max_node_size) {
+              this->do_split_child(node, j, this->do_get_split_point(idx, cnt));
+              j = node->find_child(off);
+            }
+            parents[depth] = node;
+            js[depth] = j;
+            depth += 1;
+            off -= node->child_offset(j);
+            pnode = node->children() + j;
+          }
+          auto leaf = *pnode;
+          ROCKET_ASSERT(leaf->nused < node_type::max_node_size);
+          if(leaf->nused == leaf->ncap) {
+            leaf = this->do_reallocate_leaf(pnode, noadl::min(leaf->ncap * 2 + 1, size_type(node_type::max_node_size)));
+          }
+          // Construct the element at the end, then rotate it into place.
+          allocator_traits<allocator_type>::construct(leaf->alloc, leaf->values() + leaf->nused, ::std::forward<paramsT>(params)...);
+          leaf->nused += 1;
+          for(auto i = leaf->nused - 1; i != off; --i) {
+            noadl::adl_swap(leaf->values()[i], leaf->values()[i - 1]);
+          }
+          // Update sizes on the path.
+          for(size_type d = 0; d < depth; ++d) {
+            for(auto k = js[d]; k < parents[d]->nused; ++k) {
+              parents[d]->sizes()[k] += 1;
+            }
+          }
+          return leaf->values() + off;
+        }
+      void erase_unchecked(size_type idx)
+        {
+          ROCKET_ASSERT(idx < this->size());
+          node_type *parents[node_type::max_depth];
+          size_type js[node_type::max_depth];
+          size_type depth = 0;
+          auto pnode = &(this->m_root);
+          auto off = idx;
+          for(;;) {
+            const auto node = this->do_unshare_node(pnode);
+            if(node->height == 0) {
+              break;
+            }
+            const auto j = node->find_child(off);
+            parents[depth] = node;
+            js[depth] = j;
+            depth += 1;
+            off -= node->child_offset(j);
+            pnode = node->children() + j;
+          }
+          // Rotate the element to the end, then destroy it.
+          const auto leaf = *pnode;
+          for(auto i = off; i + 1 < leaf->nused; ++i) {
+            noadl::adl_swap(leaf->values()[i], leaf->values()[i + 1]);
+          }
+          leaf->nused -= 1;
+          allocator_traits<allocator_type>::destroy(leaf->alloc, leaf->values() + leaf->nused);
+          // Update sizes on the path.
+          for(size_type d = 0; d < depth; ++d) {
+            for(auto k = js[d]; k < parents[d]->nused; ++k) {
+              parents[d]->sizes()[k] -= 1;
+            }
+          }
+          // Remove empty nodes and merge small ones, bottom-up.
+          while(depth != 0) {
+            depth -= 1;
+            const auto node = parents[depth];
+            const auto j = js[depth];
+            const auto child = node->children()[j];
+            if(child->nused == 0) {
+              node_type::release(child);
+              for(auto k = j; k + 1 < node->nused; ++k) {
+                node->children()[k] = node->children()[k + 1];
+              }
+              node->nused -= 1;
+              node->update_sizes(j);
+              continue;
+            }
+            if(node->nused < 2) {
+              continue;
+            }
+            const auto l = (j + 1 < node->nused) ? j : (j - 1);
+            if(node->children()[l]->nused + node->children()[l + 1]->nused <= node_type::max_node_size) {
+              this->do_merge_children(node, l);
+            }
+          }
+          this->do_collapse_root();
+        }
+    };
+
+  template<typename vectorT, typename valueT>
+    class rrbvector_iterator
+    {
+      template<typename, typename>
+        friend class rrbvector_iterator;
+      friend vectorT;
+
+    public:
+      using iterator_category  = ::std::random_access_iterator_tag;
+      using value_type         = valueT;
+      using pointer            = value_type *;
+      using reference          = value_type &;
+      using difference_type    = ptrdiff_t;
+
+      using parent_type   = storage_handle<typename vectorT::allocator_type>;
+      using node_type     = typename parent_type::node_type;
+      using size_type     = typename parent_type::size_type;
+
+    private:
+      const parent_type *m_ref;
+      size_type m_idx;
+      // This caches the leaf that was visited most recently, so sequential access does not have to descend from the root every time.
+      mutable const node_type *m_leaf;
+      mutable size_type m_base;
+
+    private:
+      constexpr rrbvector_iterator(const parent_type *ref, size_type idx) noexcept
+        : m_ref(ref), m_idx(idx), m_leaf(nullptr), m_base(0)
+        {
+        }
+
+    public:
+      constexpr rrbvector_iterator() noexcept
+        : rrbvector_iterator(nullptr, 0)
+        {
+        }
+      template<typename yvalueT, typename enable_if<is_convertible<yvalueT *, valueT *>::value>::type * = nullptr>
+        constexpr rrbvector_iterator(const rrbvector_iterator<vectorT, yvalueT> &other) noexcept
+          : m_ref(other.m_ref), m_idx(other.m_idx), m_leaf(other.m_leaf), m_base(other.m_base)
+        {
+        }
+
+    private:
+      size_type do_assert_valid_index(size_type idx, bool to_dereference) const noexcept
+        {
+          const auto ref = this->m_ref;
+          ROCKET_ASSERT_MSG(ref, "This iterator has not been initialized.");
+          ROCKET_ASSERT_MSG(idx <= ref->size(), "This iterator has been invalidated.");
+          ROCKET_ASSERT_MSG(!(to_dereference && (idx == ref->size())), "This iterator contains a past-the-end value and cannot be dereferenced.");
+          return idx;
+        }
+      value_type * do_get(size_type idx) const noexcept
+        {
+          // N.B. If `idx` is less than `m_base`, the subtraction wraps around.
+          if(!this->m_leaf || (idx - this->m_base >= this->m_leaf->nused)) {
+            const auto pos = this->m_ref->locate(idx);
+            this->m_leaf = pos.first;
+            this->m_base = idx - pos.second;
+          }
+          return this->m_leaf->values() + (idx - this->m_base);
+        }
+
+    public:
+      const parent_type * parent() const noexcept
+        {
+          return this->m_ref;
+        }
+
+      size_type tell() const noexcept
+        {
+          return this->do_assert_valid_index(this->m_idx, false);
+        }
+      size_type tell_owned_by(const parent_type *ref) const noexcept
+        {
+          ROCKET_ASSERT_MSG(this->m_ref == ref, "This iterator does not refer to an element in the same container.");
+          return this->tell();
+        }
+      rrbvector_iterator & seek(size_type idx) noexcept
+        {
+          this->m_idx = this->do_assert_valid_index(idx, false);
+          return *this;
+        }
+
+      reference operator*() const noexcept
+        {
+          const auto idx = this->do_assert_valid_index(this->m_idx, true);
+          return *(this->do_get(idx));
+        }
+      pointer operator->() const noexcept
+        {
+          const auto idx = this->do_assert_valid_index(this->m_idx, true);
+          return this->do_get(idx);
+        }
+      reference operator[](difference_type off) const noexcept
+        {
+          const auto idx = this->do_assert_valid_index(this->m_idx + static_cast<size_type>(off), true);
+          return *(this->do_get(idx));
+        }
+    };
+
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> & operator++(rrbvector_iterator<vectorT, valueT> &rhs) noexcept
+    {
+      return rhs.seek(rhs.tell() + 1);
+    }
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> & operator--(rrbvector_iterator<vectorT, valueT> &rhs) noexcept
+    {
+      return rhs.seek(rhs.tell() - 1);
+    }
+
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> operator++(rrbvector_iterator<vectorT, valueT> &lhs, int) noexcept
+    {
+      auto res = lhs;
+      lhs.seek(lhs.tell() + 1);
+      return res;
+    }
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> operator--(rrbvector_iterator<vectorT, valueT> &lhs, int) noexcept
+    {
+      auto res = lhs;
+      lhs.seek(lhs.tell() - 1);
+      return res;
+    }
+
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> & operator+=(rrbvector_iterator<vectorT, valueT> &lhs, typename rrbvector_iterator<vectorT, valueT>::difference_type rhs) noexcept
+    {
+      return lhs.seek(lhs.tell() + static_cast<typename rrbvector_iterator<vectorT, valueT>::size_type>(rhs));
+    }
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> & operator-=(rrbvector_iterator<vectorT, valueT> &lhs, typename rrbvector_iterator<vectorT, valueT>::difference_type rhs) noexcept
+    {
+      return lhs.seek(lhs.tell() - static_cast<typename rrbvector_iterator<vectorT, valueT>::size_type>(rhs));
+    }
+
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> operator+(const rrbvector_iterator<vectorT, valueT> &lhs, typename rrbvector_iterator<vectorT, valueT>::difference_type rhs) noexcept
+    {
+      auto res = lhs;
+      res += rhs;
+      return res;
+    }
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> operator-(const rrbvector_iterator<vectorT, valueT> &lhs, typename rrbvector_iterator<vectorT, valueT>::difference_type rhs) noexcept
+    {
+      auto res = lhs;
+      res -= rhs;
+      return res;
+    }
+
+  template<typename vectorT, typename valueT>
+    inline rrbvector_iterator<vectorT, valueT> operator+(typename rrbvector_iterator<vectorT, valueT>::difference_type lhs, const rrbvector_iterator<vectorT, valueT> &rhs) noexcept
+    {
+      auto res = rhs;
+      res += lhs;
+      return res;
+    }
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline typename rrbvector_iterator<vectorT, xvalueT>::difference_type operator-(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return static_cast<typename rrbvector_iterator<vectorT, xvalueT>::difference_type>(lhs.tell_owned_by(rhs.parent()) - rhs.tell());
+    }
+
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator==(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell() == rhs.tell();
+    }
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator!=(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell() != rhs.tell();
+    }
+
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator<(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell_owned_by(rhs.parent()) < rhs.tell();
+    }
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator>(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell_owned_by(rhs.parent()) > rhs.tell();
+    }
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator<=(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell_owned_by(rhs.parent()) <= rhs.tell();
+    }
+  template<typename vectorT, typename xvalueT, typename yvalueT>
+    inline bool operator>=(const rrbvector_iterator<vectorT, xvalueT> &lhs, const rrbvector_iterator<vectorT, yvalueT> &rhs) noexcept
+    {
+      return lhs.tell_owned_by(rhs.parent()) >= rhs.tell();
+    }
+
+  }
+
+template<typename valueT, typename allocatorT>
+  class cow_rrbvector
+  {
+    static_assert(!is_array<valueT>::value, "`valueT` must not be an array type.");
+    static_assert(is_same<typename allocatorT::value_type, valueT>::value, "`allocatorT::value_type` must denote the same type as `valueT`.");
+
+  public:
+    // types
+    using value_type      = valueT;
+    using allocator_type  = allocatorT;
+
+    using size_type        = typename allocator_traits<allocator_type>::size_type;
+    using difference_type  = typename allocator_traits<allocator_type>::difference_type;
+    using const_reference  = const value_type &;
+    using reference        = value_type &;
+
+    using const_iterator          = details_cow_rrbvector::rrbvector_iterator<cow_rrbvector, const value_type>;
+    using const_reverse_iterator  = ::std::reverse_iterator<const_iterator>;
+
+  private:
+    details_cow_rrbvector::storage_handle<allocator_type> m_sth;
+
+  public:
+    // 26.3.11.2, construct/copy/destroy
+    explicit cow_rrbvector(const allocator_type &alloc) noexcept
+      : m_sth(alloc)
+      {
+      }
+    cow_rrbvector() noexcept(is_nothrow_constructible<allocator_type>::value)
+      : cow_rrbvector(allocator_type())
+      {
+      }
+    cow_rrbvector(const cow_rrbvector &other) noexcept
+      : cow_rrbvector(allocator_traits<allocator_type>::select_on_container_copy_construction(other.m_sth.as_allocator()))
+      {
+        this->assign(other);
+      }
+    cow_rrbvector(const cow_rrbvector &other, const allocator_type &alloc) noexcept
+      : cow_rrbvector(alloc)
+      {
+        this->assign(other);
+      }
+    cow_rrbvector(cow_rrbvector &&other) noexcept
+      : cow_rrbvector(::std::move(other.m_sth.as_allocator()))
+      {
+        this->assign(::std::move(other));
+      }
+    cow_rrbvector(cow_rrbvector &&other, const allocator_type &alloc) noexcept
+      : cow_rrbvector(alloc)
+      {
+        this->assign(::std::move(other));
+      }
+    cow_rrbvector(size_type n, const allocator_type &alloc = allocator_type())
+      : cow_rrbvector(alloc)
+      {
+        this->assign(n);
+      }
+    cow_rrbvector(size_type n, const value_type &value, const allocator_type &alloc = allocator_type())
+      : cow_rrbvector(alloc)
+      {
+        this->assign(n, value);
+      }
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_rrbvector(inputT first, inputT last, const allocator_type &alloc = allocator_type())
+      : cow_rrbvector(alloc)
+      {
+        this->assign(::std::move(first), ::std::move(last));
+      }
+    cow_rrbvector(initializer_list<value_type> init, const allocator_type &alloc = allocator_type())
+      : cow_rrbvector(alloc)
+      {
+        this->assign(init);
+      }
+    cow_rrbvector & operator=(const cow_rrbvector &other) noexcept
+      {
+        this->assign(other);
+        allocator_copy_assigner<allocator_type>()(this->m_sth.as_allocator(), other.m_sth.as_allocator());
+        return *this;
+      }
+    cow_rrbvector & operator=(cow_rrbvector &&other) noexcept
+      {
+        this->assign(::std::move(other));
+        allocator_move_assigner<allocator_type>()(this->m_sth.as_allocator(), ::std::move(other.m_sth.as_allocator()));
+        return *this;
+      }
+    cow_rrbvector & operator=(initializer_list<value_type> init)
+      {
+        this->assign(init);
+        return *this;
+      }
+
+  public:
+    // iterators
+    const_iterator begin() const noexcept
+      {
+        return const_iterator(this->m_sth, 0);
+      }
+    const_iterator end() const noexcept
+      {
+        return const_iterator(this->m_sth, this->size());
+      }
+    const_reverse_iterator rbegin() const noexcept
+      {
+        return const_reverse_iterator(this->end());
+      }
+    const_reverse_iterator rend() const noexcept
+      {
+        return const_reverse_iterator(this->begin());
+      }
+
+    const_iterator cbegin() const noexcept
+      {
+        return this->begin();
+      }
+    const_iterator cend() const noexcept
+      {
+        return this->end();
+      }
+    const_reverse_iterator crbegin() const noexcept
+      {
+        return this->rbegin();
+      }
+    const_reverse_iterator crend() const noexcept
+      {
+        return this->rend();
+      }
+
+    // 26.3.11.3, capacity
+    bool empty() const noexcept
+      {
+        return this->m_sth.size() == 0;
+      }
+    size_type size() const noexcept
+      {
+        return this->m_sth.size();
+      }
+    size_type max_size() const noexcept
+      {
+        return this->m_sth.max_size();
+      }
+    // N.B. The parameter pack is a non-standard extension.
+    template<typename ...paramsT>
+      void resize(size_type n, const paramsT &...params)
+      {
+        const auto cnt_old = this->size();
+        if(cnt_old == n) {
+          return;
+        }
+        if(cnt_old < n) {
+          this->append(n - cnt_old, params...);
+        } else {
+          this->pop_back(cnt_old - n);
+        }
+        ROCKET_ASSERT(this->size() == n);
+      }
+    // N.B. Storage can only be reserved for vectors that consist of a single leaf.
+    void reserve(size_type res_arg)
+      {
+        this->m_sth.reserve_leaf(noadl::max(this->size(), res_arg));
+      }
+    void clear() noexcept
+      {
+        this->m_sth.deallocate();
+      }
+    // N.B. This is a non-standard extension.
+    bool unique() const noexcept
+      {
+        return this->m_sth.unique();
+      }
+    // N.B. This is a non-standard extension.
+    long use_count() const noexcept
+      {
+        return this->m_sth.use_count();
+      }
+    // N.B. This is a non-standard extension.
+    // Returns a pointer that identifies the root of the tree, which is shared by copies of this vector until they are
+    // modified. If this vector is empty, a null pointer is returned.
+    const void * root_id() const noexcept
+      {
+        return this->m_sth.root_id();
+      }
+    // N.B. This is a non-standard extension.
+    // Returns `true` if a node other than the root is shared with another vector, which happens when one that shared
+    // the root with this vector has been modified.
+    bool has_shared_subtrees() const noexcept
+      {
+        return this->m_sth.has_shared_subtrees();
+      }
+
+    // element access
+    const_reference at(size_type pos) const
+      {
+        const auto cnt = this->size();
+        if(pos >= cnt) {
+          noadl::throw_out_of_range("cow_rrbvector: The subscript `%lld` is not a writable position within a vector of size `%lld`.",
+                                    static_cast<long long>(pos), static_cast<long long>(cnt));
+        }
+        const auto loc = this->m_sth.locate(pos);
+        return loc.first->values()[loc.second];
+      }
+    const_reference operator[](size_type pos) const noexcept
+      {
+        const auto cnt = this->size();
+        ROCKET_ASSERT(pos < cnt);
+        const auto loc = this->m_sth.locate(pos);
+        return loc.first->values()[loc.second];
+      }
+    const_reference front() const noexcept
+      {
+        const auto cnt = this->size();
+        ROCKET_ASSERT(cnt > 0);
+        return this->operator[](0);
+      }
+    const_reference back() const noexcept
+      {
+        const auto cnt = this->size();
+        ROCKET_ASSERT(cnt > 0);
+        return this->operator[](cnt - 1);
+      }
+
+    // There is no `at()` overload that returns a non-const reference. This is the consequent overload which does that.
+    // N.B. This is a non-standard extension.
+    reference mut(size_type pos)
+      {
+        const auto cnt = this->size();
+        if(pos >= cnt) {
+          noadl::throw_out_of_range("cow_rrbvector: The subscript `%lld` is not a writable position within a vector of size `%lld`.",
+                                    static_cast<long long>(pos), static_cast<long long>(cnt));
+        }
+        return *(this->m_sth.mut_element(pos));
+      }
+    // N.B. This is a non-standard extension.
+    reference mut_front()
+      {
+        const auto cnt = this->size();
+        ROCKET_ASSERT(cnt > 0);
+        return *(this->m_sth.mut_element(0));
+      }
+    // N.B. This is a non-standard extension.
+    reference mut_back()
+      {
+        const auto cnt = this->size();
+        ROCKET_ASSERT(cnt > 0);
+        return *(this->m_sth.mut_element(cnt - 1));
+      }
+
+    // N.B. This is a non-standard extension.
+    template<typename ...paramsT>
+      cow_rrbvector & append(size_type n, const paramsT &...params)
+      {
+        if(n == 0) {
+          return *this;
+        }
+        this->m_sth.check_size_add(this->size(), n);
+        noadl::ranged_do_while(size_type(0), n, [&](size_type, const paramsT &...fwdp) { this->emplace_back(fwdp...); }, params...);
+        return *this;
+      }
+    // N.B. This is a non-standard extension.
+    cow_rrbvector & append(initializer_list<value_type> init)
+      {
+        return this->append(init.begin(), init.end());
+      }
+    // N.B. This is a non-standard extension.
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_rrbvector & append(inputT first, inputT last)
+      {
+        if(first == last) {
+          return *this;
+        }
+        noadl::ranged_do_while(::std::move(first), ::std::move(last), [&](const inputT &it) { this->emplace_back(*it); });
+        return *this;
+      }
+    // 26.3.11.5, modifiers
+    template<typename ...paramsT>
+      reference emplace_back(paramsT &&...params)
+      {
+        const auto ptr = this->m_sth.insert_unchecked(this->size(), ::std::forward<paramsT>(params)...);
+        return *ptr;
+      }
+    // N.B. The return type is a non-standard extension.
+    reference push_back(const value_type &value)
+      {
+        // `value` might be an element of this vector, which may be moved by the insertion.
+        auto copy = value;
+        const auto ptr = this->m_sth.insert_unchecked(this->size(), ::std::move(copy));
+        return *ptr;
+      }
+    // N.B. The return type is a non-standard extension.
+    reference push_back(value_type &&value)
+      {
+        const auto ptr = this->m_sth.insert_unchecked(this->size(), ::std::move(value));
+        return *ptr;
+      }
+
+    const_iterator insert(const_iterator tins, const value_type &value)
+      {
+        const auto tpos = tins.tell_owned_by(this->m_sth);
+        // `value` might be an element of this vector, which may be moved by the insertion.
+        auto copy = value;
+        this->m_sth.insert_unchecked(tpos, ::std::move(copy));
+        return const_iterator(this->m_sth, tpos);
+      }
+    const_iterator insert(const_iterator tins, value_type &&value)
+      {
+        const auto tpos = tins.tell_owned_by(this->m_sth);
+        this->m_sth.insert_unchecked(tpos, ::std::move(value));
+        return const_iterator(this->m_sth, tpos);
+      }
+    // N.B. The parameter pack is a non-standard extension.
+    template<typename ...paramsT>
+      const_iterator insert(const_iterator tins, size_type n, const paramsT &...params)
+      {
+        const auto tpos = tins.tell_owned_by(this->m_sth);
+        this->m_sth.check_size_add(this->size(), n);
+        // All elements are equivalent, so insert them at the same position, which is optimal if it is either end.
+        for(size_type i = 0; i < n; ++i) {
+          this->m_sth.insert_unchecked(tpos, params...);
+        }
+        return const_iterator(this->m_sth, tpos);
+      }
+    const_iterator insert(const_iterator tins, initializer_list<value_type> init)
+      {
+        return this->insert(tins, init.begin(), init.end());
+      }
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      const_iterator insert(const_iterator tins, inputT first, inputT last)
+      {
+        const auto tpos = tins.tell_owned_by(this->m_sth);
+        if(first == last) {
+          return const_iterator(this->m_sth, tpos);
+        }
+        auto tcur = tpos;
+        noadl::ranged_do_while(::std::move(first), ::std::move(last), [&](const inputT &it) { this->m_sth.insert_unchecked(tcur++, *it); });
+        return const_iterator(this->m_sth, tpos);
+      }
+
+    // N.B. This function may throw `std::bad_alloc`.
+    const_iterator erase(const_iterator tfirst, const_iterator tlast)
+      {
+        const auto tpos = tfirst.tell_owned_by(this->m_sth);
+        const auto tn = tlast.tell_owned_by(this->m_sth) - tpos;
+        for(size_type i = 0; i < tn; ++i) {
+          this->m_sth.erase_unchecked(tpos);
+        }
+        return const_iterator(this->m_sth, tpos);
+      }
+    // N.B. This function may throw `std::bad_alloc`.
+    const_iterator erase(const_iterator tfirst)
+      {
+        const auto tpos = tfirst.tell_owned_by(this->m_sth);
+        this->m_sth.erase_unchecked(tpos);
+        return const_iterator(this->m_sth, tpos);
+      }
+    // N.B. This function may throw `std::bad_alloc`.
+    // N.B. The return type and parameter are non-standard extensions.
+    cow_rrbvector & pop_back(size_type n = 1)
+      {
+        const auto cnt_old = this->size();
+        ROCKET_ASSERT(n <= cnt_old);
+        if(n == cnt_old) {
+          this->clear();
+          return *this;
+        }
+        for(size_type i = 0; i < n; ++i) {
+          this->m_sth.erase_unchecked(cnt_old - 1 - i);
+        }
+        return *this;
+      }
+
+    // Gets a vector of elements `[tpos, tpos + tn)`. Nodes that are not modified are shared with this vector.
+    // N.B. This is a non-standard extension.
+    cow_rrbvector subvector(size_type tpos, size_type tn = size_type(-1)) const
+      {
+        const auto cnt = this->size();
+        if(tpos > cnt) {
+          noadl::throw_out_of_range("cow_rrbvector: The subscript `%lld` is out of range for a vector of size `%lld`.",
+                                    static_cast<long long>(tpos), static_cast<long long>(cnt));
+        }
+        cow_rrbvector res(this->m_sth.as_allocator());
+        res.m_sth.slice_from(this->m_sth, tpos, noadl::min(cnt - tpos, tn));
+        return res;
+      }
+
+    // N.B. The return type is a non-standard extension.
+    cow_rrbvector & assign(const cow_rrbvector &other) noexcept
+      {
+        this->m_sth.share_with(other.m_sth);
+        return *this;
+      }
+    // N.B. The return type is a non-standard extension.
+    cow_rrbvector & assign(cow_rrbvector &&other) noexcept
+      {
+        this->m_sth.share_with(::std::move(other.m_sth));
+        return *this;
+      }
+    // N.B. The parameter pack is a non-standard extension.
+    // N.B. The return type is a non-standard extension.
+    template<typename ...paramsT>
+      cow_rrbvector & assign(size_type n, const paramsT &...params)
+      {
+        this->clear();
+        this->append(n, params...);
+        return *this;
+      }
+    // N.B. The return type is a non-standard extension.
+    cow_rrbvector & assign(initializer_list<value_type> init)
+      {
+        this->clear();
+        this->append(init);
+        return *this;
+      }
+    // N.B. The return type is a non-standard extension.
+    template<typename inputT, typename iterator_traits<inputT>::iterator_category * = nullptr>
+      cow_rrbvector & assign(inputT first, inputT last)
+      {
+        this->clear();
+        this->append(::std::move(first), ::std::move(last));
+        return *this;
+      }
+
+    void swap(cow_rrbvector &other) noexcept
+      {
+        this->m_sth.exchange_with(other.m_sth);
+        allocator_swapper<allocator_type>()(this->m_sth.as_allocator(), other.m_sth.as_allocator());
+      }
+
+    // N.B. The return type differs from `std::vector`.
+    const allocator_type & get_allocator() const noexcept
+      {
+        return this->m_sth.as_allocator();
+      }
+    allocator_type & get_allocator() noexcept
+      {
+        return this->m_sth.as_allocator();
+      }
+  };
+
+template<typename valueT, typename allocatorT>
+  inline void swap(cow_rrbvector<valueT, allocatorT> &lhs, cow_rrbvector<valueT, allocatorT> &rhs) noexcept
+  {
+    lhs.swap(rhs);
+  }
+
+}
+
+#endif
@@ -31,6 +31,8 @@
  * 5. The assignment operator taking a character and the one taking a const pointer are not provided.
  * 6. It is possible to create strings holding non-owning references of null-terminated character arrays allocated externally.
  * 7. `data()` returns a null pointer if the string is empty.
+ * 8. Short strings are stored in-place and are copied rather than shared.
+ * 9. `substr()` returns a string sharing storage with `*this` if the result is a long enough suffix.
  */
 
 namespace rocket {
@@ -113,18 +115,24 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
       using storage_allocator = typename allocator_traits<allocator_type>::template rebind_alloc<storage>;
       using storage_pointer   = typename allocator_traits<storage_allocator>::pointer;
 
+    public:
+      // Short strings are stored in-place, which occupies the same space as three pointers, not including the null terminator.
+      enum : size_type { small_capacity = (sizeof(storage_pointer) * 3 - sizeof(bool)) / sizeof(value_type) - 1 };
+
     private:
       storage_pointer m_ptr;
+      value_type m_sbuf[small_capacity + 1];
+      bool m_small;
 
     public:
       explicit constexpr storage_handle(const allocator_type &alloc) noexcept
         : allocator_base(alloc),
-          m_ptr()
+          m_ptr(), m_sbuf(), m_small(false)
         {
         }
       explicit constexpr storage_handle(allocator_type &&alloc) noexcept
         : allocator_base(::std::move(alloc)),
-          m_ptr()
+          m_ptr(), m_sbuf(), m_small(false)
         {
         }
       ~storage_handle()
@@ -170,8 +178,16 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
           return static_cast<allocator_base &>(*this);
         }
 
+      bool small() const noexcept
+        {
+          return this->m_small;
+        }
       bool unique() const noexcept
         {
+          if(this->m_small) {
+            // The in-place buffer is never shared.
+            return true;
+          }
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return false;
@@ -180,6 +196,9 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
         }
       size_type capacity() const noexcept
         {
+          if(this->m_small) {
+            return small_capacity;
+          }
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return 0;
@@ -205,11 +224,17 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
       size_type round_up_capacity(size_type res_arg) const
         {
           const auto cap = this->check_size_add(0, res_arg);
+          if(cap <= small_capacity) {
+            return small_capacity;
+          }
           const auto nblk = storage::min_nblk_for_nchar(cap);
           return storage::max_nchar_for_nblk(nblk);
         }
       const value_type * data() const noexcept
         {
+          if(this->m_small) {
+            return this->m_sbuf;
+          }
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return nullptr;
@@ -224,6 +249,20 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
             return nullptr;
           }
           const auto cap = this->check_size_add(0, res_arg);
+          if(cap <= small_capacity) {
+            // Move characters into the in-place buffer, which may overlap with the source, then add a null character.
+            ROCKET_ASSERT(len_one <= cap);
+            traits_type::move(this->m_sbuf, src, len_one);
+            auto len = len_one;
+            ROCKET_ASSERT(len_two <= cap - len);
+            traits_type::move(this->m_sbuf + len, src + off_two, len_two);
+            len += len_two;
+            traits_type::assign(this->m_sbuf[len], value_type());
+            // Release the current block, if any.
+            this->do_reset(storage_pointer());
+            this->m_small = true;
+            return this->m_sbuf;
+          }
           // Allocate an array of `storage` large enough for a header + `cap` instances of `value_type`.
           const auto nblk = storage::min_nblk_for_nchar(cap);
           auto st_alloc = storage_allocator(this->as_allocator());
@@ -242,15 +281,24 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
           traits_type::assign(ptr->data[len], value_type());
           // Replace the current block.
           this->do_reset(ptr);
+          this->m_small = false;
           return ptr->data;
         }
       void deallocate() noexcept
         {
           this->do_reset(storage_pointer());
+          this->m_small = false;
         }
 
       void share_with(const storage_handle &other) noexcept
         {
+          if(other.m_small) {
+            // Short strings are copied rather than shared.
+            this->do_reset(storage_pointer());
+            traits_type::move(this->m_sbuf, other.m_sbuf, small_capacity + 1);
+            this->m_small = true;
+            return;
+          }
           const auto ptr = other.m_ptr;
           if(ptr) {
             // Increment the reference count.
@@ -258,19 +306,34 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
             ROCKET_ASSERT(nref_old >= 1);
           }
           this->do_reset(ptr);
+          this->m_small = false;
         }
       void share_with(storage_handle &&other) noexcept
         {
+          if(other.m_small) {
+            // Short strings are copied rather than shared.
+            this->do_reset(storage_pointer());
+            traits_type::move(this->m_sbuf, other.m_sbuf, small_capacity + 1);
+            this->m_small = true;
+            if(&other != this) {
+              // Detach the in-place buffer.
+              other.m_small = false;
+            }
+            return;
+          }
           const auto ptr = other.m_ptr;
           if(ptr) {
             // Detach the block.
             other.m_ptr = storage_pointer();
           }
           this->do_reset(ptr);
+          this->m_small = false;
         }
       void exchange_with(storage_handle &other) noexcept
         {
           ::std::swap(this->m_ptr, other.m_ptr);
+          ::std::swap(this->m_sbuf, other.m_sbuf);
+          ::std::swap(this->m_small, other.m_small);
         }
 
       constexpr operator const storage_handle * () const noexcept
@@ -284,6 +347,9 @@ template<typename charT, typename traitsT = char_traits<charT>, typename allocat
 
       value_type * mut_data_unchecked() noexcept
         {
+          if(this->m_small) {
+            return this->m_sbuf;
+          }
           const auto ptr = this->m_ptr;
           if(!ptr) {
             return nullptr;
@@ -758,6 +824,14 @@ template<typename charT, typename traitsT, typename allocatorT>
         this->m_ptr = shallow().data();
         this->m_len = 0;
       }
+    // The in-place buffer moves along with this string, so `m_ptr` has to be updated after it is copied or swapped.
+    void do_rebind_small() noexcept
+      {
+        if(!this->m_sth.small()) {
+          return;
+        }
+        this->m_ptr = this->m_sth.data();
+      }
 
     // Reallocate more storage as needed, without shrinking.
     void do_reserve_more(size_type cap_add)
@@ -766,10 +840,12 @@ template<typename charT, typename traitsT, typename allocatorT>
         auto cap = this->m_sth.check_size_add(len, cap_add);
         if(!this->unique() || (this->capacity() < cap)) {
 #ifndef ROCKET_DEBUG
-          // Reserve more space for non-debug builds.
-          cap = noadl::max(cap, len + len / 2 + 31);
+          // Reserve more space for non-debug builds, unless the string still fits in the in-place buffer.
+          if(cap > this->m_sth.small_capacity) {
+            cap = noadl::max(cap, len + len / 2 + 31);
+          }
 #endif
-          this->do_reallocate(0, 0, len, cap | 1);
+          this->do_reallocate(0, 0, len, noadl::max(cap, size_type(1)));
         }
         ROCKET_ASSERT(this->capacity() >= cap);
       }
@@ -991,7 +1067,8 @@ template<typename charT, typename traitsT, typename allocatorT>
     // N.B. This is a non-standard extension.
     bool unique() const noexcept
       {
-        return this->m_sth.unique();
+        // A string that refers to a suffix of its storage has to be reallocated before modification.
+        return (this->m_ptr == this->m_sth.data()) && this->m_sth.unique();
       }
 
     // 24.3.2.5, element access
@@ -1191,6 +1268,7 @@ template<typename charT, typename traitsT, typename allocatorT>
         this->m_sth.share_with(other.m_sth);
         this->m_ptr = other.m_ptr;
         this->m_len = other.m_len;
+        this->do_rebind_small();
         return *this;
       }
     basic_cow_string & assign(basic_cow_string &&other) noexcept
@@ -1198,6 +1276,7 @@ template<typename charT, typename traitsT, typename allocatorT>
         this->m_sth.share_with(::std::move(other.m_sth));
         this->m_ptr = noadl::exchange(other.m_ptr, shallow().data());
         this->m_len = noadl::exchange(other.m_len, size_type(0));
+        this->do_rebind_small();
         return *this;
       }
     basic_cow_string & assign(shallow sh) noexcept
@@ -1423,6 +1502,8 @@ template<typename charT, typename traitsT, typename allocatorT>
         this->m_sth.exchange_with(other.m_sth);
         ::std::swap(this->m_ptr, other.m_ptr);
         ::std::swap(this->m_len, other.m_len);
+        this->do_rebind_small();
+        other.do_rebind_small();
         allocator_swapper<allocator_type>()(this->m_sth.as_allocator(), other.m_sth.as_allocator());
       }
 
@@ -1441,7 +1522,7 @@ template<typename charT, typename traitsT, typename allocatorT>
     value_type * mut_data()
       {
         if(!this->unique()) {
-          return this->do_reallocate(0, 0, this->size(), this->size() | 1);
+          return this->do_reallocate(0, 0, this->size(), noadl::max(this->size(), size_type(1)));
         }
         return this->m_sth.mut_data_unchecked();
       }
@@ -1647,7 +1728,15 @@ template<typename charT, typename traitsT, typename allocatorT>
           // Utilize reference counting.
           return basic_cow_string(*this, this->m_sth.as_allocator());
         }
-        return basic_cow_string(*this, pos, n, this->m_sth.as_allocator());
+        const auto rlen = this->do_clamp_substr(pos, n);
+        if((rlen == this->size() - pos) && (rlen > this->m_sth.small_capacity) && !(this->m_sth.small())) {
+          // A suffix is null-terminated as well, so it can share storage with this string.
+          auto res = basic_cow_string(*this, this->m_sth.as_allocator());
+          res.m_ptr += pos;
+          res.m_len = rlen;
+          return res;
+        }
+        return basic_cow_string(*this, pos, rlen, this->m_sth.as_allocator());
       }
 
     int compare(shallow sh) const noexcept
@@ -287,7 +287,7 @@ template<typename elementT, typename deleterT>
     template<typename yelementT = elementT>
       refcounted_ptr<const yelementT> share_this() const
       {
-        const auto ptr = details_refcounted_ptr::static_cast_or_dynamic_cast_helper<const yelementT *, const refcounted_base *>(this);
+        const auto ptr = details_refcounted_ptr::static_cast_or_dynamic_cast_helper<const yelementT *, const refcounted_base *>()(this);
         if(!ptr) {
           noadl::throw_domain_error("refcounted_base: The current object cannot be converted to type `%s`, whose most derived type is `%s`.",
                                     typeid(yelementT).name(), typeid(*this).name());
@@ -298,7 +298,7 @@ template<typename elementT, typename deleterT>
     template<typename yelementT = elementT>
       refcounted_ptr<yelementT> share_this()
       {
-        const auto ptr = details_refcounted_ptr::static_cast_or_dynamic_cast_helper<yelementT *, refcounted_base *>(this);
+        const auto ptr = details_refcounted_ptr::static_cast_or_dynamic_cast_helper<yelementT *, refcounted_base *>()(this);
         if(!ptr) {
           noadl::throw_domain_error("refcounted_base: The current object cannot be converted to type `%s`, whose most derived type is `%s`.",
                                     typeid(yelementT).name(), typeid(*this).name());
@@ -262,7 +262,8 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
         const auto &alt = this->m_stor.as<S_if>();
         // Evaluate the condition and pick a branch.
         ref_out = alt.cond.evaluate(global, ctx_io);
-        const auto status = (ref_out.read().test() ? alt.branch_true : alt.branch_false).execute(ref_out, global, ctx_io);
+        Value cond_temp;
+        const auto status = (ref_out.peek(cond_temp).test() ? alt.branch_true : alt.branch_false).execute(ref_out, global, ctx_io);
         if(status != Block::status_next) {
           // Forward anything unexpected to the caller.
           return status;
@@ -340,7 +341,8 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
           // Check the loop condition.
           // This differs from a `while` loop where the context for the loop body is destroyed before this check.
           ref_out = alt.cond.evaluate(global, ctx_next);
-          if(!ref_out.read().test()) {
+          Value cond_temp;
+          if(!ref_out.peek(cond_temp).test()) {
             break;
           }
         }
@@ -351,7 +353,8 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
         for(;;) {
           // Check the loop condition.
           ref_out = alt.cond.evaluate(global, ctx_io);
-          if(!ref_out.read().test()) {
+          Value cond_temp;
+          if(!ref_out.peek(cond_temp).test()) {
             break;
           }
           // Execute the loop body.
@@ -379,7 +382,8 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
           // Check the loop condition.
           if(!alt.cond.empty()) {
             ref_out = alt.cond.evaluate(global, ctx_next);
-            if(!ref_out.read().test()) {
+            Value cond_temp;
+            if(!ref_out.peek(cond_temp).test()) {
               break;
             }
           }
@@ -411,15 +415,15 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
         switch(rocket::weaken_enum(range_value.type())) {
           case Value::type_array: {
             const auto &array = range_value.check<D_array>();
-            for(auto it = array.begin(); it != array.end(); ++it) {
+            for(Size i = 0; i < array.size(); ++i) {
               Executive_context ctx_next(&ctx_for);
               // Initialize the per-loop key constant.
-              auto key = D_integer(it - array.begin());
+              auto key = D_integer(i);
               ASTERIA_DEBUG_LOG("Creating key constant with `for each` scope: name = ", alt.key_name, ": ", key);
               Reference_root::S_constant ref_c = { std::move(key) };
               do_safe_set_named_reference(ctx_for, "`for each` key", alt.key_name, std::move(ref_c));
               // Initialize the per-loop value reference.
-              Reference_modifier::S_array_index refmod_c = { it - array.begin() };
+              Reference_modifier::S_array_index refmod_c = { D_integer(i) };
               mapped.zoom_in(std::move(refmod_c));
               do_safe_set_named_reference(ctx_for, "`for each` reference", alt.mapped_name, mapped);
               ASTERIA_DEBUG_LOG("Created value reference with `for each` scope: name = ", alt.mapped_name, ": ", mapped.read());
@@ -447,7 +451,7 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
               Reference_root::S_constant ref_c = { std::move(key) };
               do_safe_set_named_reference(ctx_for, "`for each` key", alt.key_name, std::move(ref_c));
               // Initialize the per-loop value reference.
-              Reference_modifier::S_object_key refmod_c = { it->first };
+              Reference_modifier::S_object_key refmod_c(it->first);
               mapped.zoom_in(std::move(refmod_c));
               do_safe_set_named_reference(ctx_for, "`for each` reference", alt.mapped_name, mapped);
               ASTERIA_DEBUG_LOG("Created value reference with `for each` scope: name = ", alt.mapped_name, ": ", mapped.read());
@@ -490,7 +494,7 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
                 D_object elem;
                 elem.insert_or_assign(String::shallow("file"), D_string(loc.get_file()));
                 elem.insert_or_assign(String::shallow("line"), D_integer(loc.get_line()));
-                backtrace.emplace_back(std::move(elem));
+                backtrace.push_back(std::move(elem));
               };
           // The exception variable shall not outlast the `catch` body.
           Executive_context ctx_next(&ctx_io);
@@ -569,8 +573,11 @@ Block::Status Statement::execute_in_place(Reference &ref_out, Executive_context
         // Evaluate the expression.
         ref_out = alt.expr.evaluate(global, ctx_io);
         // If `by_ref` is `false`, replace it with a temporary value.
+        // Otherwise, the reference may outlive the AST, so it shall not refer to constants in it.
         if(!alt.by_ref) {
           ref_out.convert_to_temporary();
+        } else {
+          ref_out.convert_to_constant();
         }
         return Block::status_return;
       }
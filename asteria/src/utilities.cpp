@@ -352,4 +352,45 @@ std::ostream & operator<<(std::ostream &os, const Quote &q)
     return os;
   }
 
+std::int64_t checked_add(std::int64_t lhs, std::int64_t rhs)
+  {
+    using Limits = std::numeric_limits<std::int64_t>;
+    if((rhs >= 0) ? (lhs > Limits::max() - rhs) : (lhs < Limits::min() - rhs)) {
+      ASTERIA_THROW_RUNTIME_ERROR("Integral addition of `", lhs, "` and `", rhs, "` would result in overflow.");
+    }
+    return lhs + rhs;
+  }
+
+std::int64_t checked_subtract(std::int64_t lhs, std::int64_t rhs)
+  {
+    using Limits = std::numeric_limits<std::int64_t>;
+    if((rhs >= 0) ? (lhs < Limits::min() + rhs) : (lhs > Limits::max() + rhs)) {
+      ASTERIA_THROW_RUNTIME_ERROR("Integral subtraction of `", lhs, "` and `", rhs, "` would result in overflow.");
+    }
+    return lhs - rhs;
+  }
+
+std::int64_t checked_multiply(std::int64_t lhs, std::int64_t rhs)
+  {
+    using Limits = std::numeric_limits<std::int64_t>;
+    if((lhs == 0) || (rhs == 0)) {
+      return 0;
+    }
+    if((lhs == 1) || (rhs == 1)) {
+      return lhs ^ rhs ^ 1;
+    }
+    if((lhs == Limits::min()) || (rhs == Limits::min())) {
+      ASTERIA_THROW_RUNTIME_ERROR("Integral multiplication of `", lhs, "` and `", rhs, "` would result in overflow.");
+    }
+    if((lhs == -1) || (rhs == -1)) {
+      return -(lhs ^ rhs ^ -1);
+    }
+    const auto slhs = (rhs >= 0) ? lhs : -lhs;
+    const auto arhs = (rhs >= 0) ? rhs : -rhs;
+    if((slhs >= 0) ? (slhs > Limits::max() / arhs) : (slhs < Limits::min() / arhs)) {
+      ASTERIA_THROW_RUNTIME_ERROR("Integral multiplication of `", lhs, "` and `", rhs, "` would result in overflow.");
+    }
+    return slhs * arhs;
+  }
+
 }
@@ -185,6 +185,11 @@ extern std::ostream & operator<<(std::ostream &os, const Quote &q);
 // Miscellaneous
 ///////////////////////////////////////////////////////////////////////////////
 
+// These functions perform arithmetic on 64-bit integers, throwing an exception if the result would overflow.
+extern std::int64_t checked_add(std::int64_t lhs, std::int64_t rhs);
+extern std::int64_t checked_subtract(std::int64_t lhs, std::int64_t rhs);
+extern std::int64_t checked_multiply(std::int64_t lhs, std::int64_t rhs);
+
 inline std::uint64_t wrap_index(std::uint64_t &bfill_out, std::uint64_t &efill_out, std::int64_t index, std::size_t size)
   {
     const auto rsize = static_cast<std::int64_t>(size);
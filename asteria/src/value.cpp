@@ -157,17 +157,14 @@ Value::Compare Value::compare(const Value &other) const noexcept
       case type_array: {
         const auto &alt_lhs = this->check<D_array>();
         const auto &alt_rhs = other.check<D_array>();
-        auto pl = alt_lhs.begin(), el = alt_lhs.end();
-        auto pr = alt_rhs.begin(), er = alt_rhs.end();
-        while((pl != el) && (pr != er)) {
-          const auto r = pl->compare(*pr);
+        const auto size_min = rocket::min(alt_lhs.size(), alt_rhs.size());
+        for(Size i = 0; i < size_min; ++i) {
+          const auto r = alt_lhs.at(i).compare(alt_rhs.at(i));
           if(r != Value::compare_equal) {
             return r;
           }
-          ++pl;
-          ++pr;
         }
-        return do_three_way_compare(el - pl, er - pr);
+        return do_three_way_compare(alt_lhs.size(), alt_rhs.size());
       }
       case type_object: {
         return Value::compare_unordered;
@@ -239,9 +236,9 @@ void Value::dump(std::ostream &os, Size indent_increment, Size indent_next) cons
         //   2 = integer 3;
         // ]
         os <<"array(" <<std::dec <<alt.size() <<") [";
-        for(auto it = alt.begin(); it != alt.end(); ++it) {
-          os <<do_indent_or_space(indent_increment, indent_next + indent_increment) <<std::dec <<(it - alt.begin()) <<" = ";
-          it->dump(os, indent_increment, indent_next + indent_increment);
+        for(Size i = 0; i < alt.size(); ++i) {
+          os <<do_indent_or_space(indent_increment, indent_next + indent_increment) <<std::dec <<i <<" = ";
+          alt.at(i).dump(os, indent_increment, indent_next + indent_increment);
           os <<';';
         }
         os <<do_indent_or_space(indent_increment, indent_next) <<']';
@@ -269,6 +266,32 @@ void Value::dump(std::ostream &os, Size indent_increment, Size indent_next) cons
     }
   }
 
+bool Value::may_contain_variables() const noexcept
+  {
+    switch(this->type()) {
+      case type_null:
+      case type_boolean:
+      case type_integer:
+      case type_real:
+      case type_string: {
+        return false;
+      }
+      case type_opaque:
+      case type_function: {
+        return true;
+      }
+      case type_array: {
+        return this->check<D_array>().may_contain_variables();
+      }
+      case type_object: {
+        return this->check<D_object>().may_contain_variables();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown value type enumeration `", this->type(), "` has been encountered.");
+      }
+    }
+  }
+
 void Value::enumerate_variables(const Abstract_variable_callback &callback) const
   {
     switch(this->type()) {
@@ -282,18 +305,35 @@ void Value::enumerate_variables(const Abstract_variable_callback &callback) cons
       }
       case type_function: {
         const auto &alt = this->check<D_function>();
+        if(!callback.accept_function(alt)) {
+          return;
+        }
         alt->enumerate_variables(callback);
         return;
       }
       case type_array: {
+        // Unboxed arrays and arrays of scalars contain no variables.
         const auto &alt = this->check<D_array>();
-        for(auto it = alt.begin(); it != alt.end(); ++it) {
+        if(!alt.may_contain_variables()) {
+          return;
+        }
+        if(!callback.accept_array(alt)) {
+          return;
+        }
+        const auto qelems = alt.opt<Persistent_vector<Value>>();
+        for(auto it = qelems->begin(); it != qelems->end(); ++it) {
           it->enumerate_variables(callback);
         }
         return;
       }
       case type_object: {
         const auto &alt = this->check<D_object>();
+        if(!alt.may_contain_variables()) {
+          return;
+        }
+        if(!callback.accept_object(alt)) {
+          return;
+        }
         for(auto it = alt.begin(); it != alt.end(); ++it) {
           it->second.enumerate_variables(callback);
         }
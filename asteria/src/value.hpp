@@ -5,8 +5,12 @@
 #define ASTERIA_VALUE_HPP_
 
 #include "fwd.hpp"
+#include "value_array.hpp"
+#include "value_object.hpp"
+#include "value_string.hpp"
 #include "shared_opaque_wrapper.hpp"
 #include "shared_function_wrapper.hpp"
+#include "abstract_variable_callback.hpp"
 #include "rocket/variant.hpp"
 #include "rocket/refcounted_ptr.hpp"
 
@@ -108,7 +112,56 @@ class Value
     Compare compare(const Value &other) const noexcept;
     void dump(std::ostream &os, Size indent_increment = 2, Size indent_next = 0) const;
 
+    // If this function returns `false`, no variable is reachable from this value, so it cannot be part of a cycle.
+    bool may_contain_variables() const noexcept;
     void enumerate_variables(const Abstract_variable_callback &callback) const;
+    // This function is equivalent to `enumerate_variables()`, but `func` is called directly and arrays and objects
+    // are traversed inline. `func` is wrapped in a `Variable_callback` only when a function is encountered.
+    template<typename FunctionT>
+      void enumerate_variables_with(FunctionT &&func) const
+      {
+        switch(this->type()) {
+          case type_null:
+          case type_boolean:
+          case type_integer:
+          case type_real:
+          case type_string:
+          case type_opaque: {
+            return;
+          }
+          case type_function: {
+            const Variable_callback<FunctionT &> callback(func);
+            this->check<D_function>()->enumerate_variables(callback);
+            return;
+          }
+          case type_array: {
+            // Unboxed arrays and arrays of scalars contain no variables.
+            const auto &alt = this->check<D_array>();
+            if(!alt.may_contain_variables()) {
+              return;
+            }
+            const auto qelems = alt.opt<Persistent_vector<Value>>();
+            for(auto it = qelems->begin(); it != qelems->end(); ++it) {
+              it->enumerate_variables_with(func);
+            }
+            return;
+          }
+          case type_object: {
+            const auto &alt = this->check<D_object>();
+            if(!alt.may_contain_variables()) {
+              return;
+            }
+            for(auto it = alt.begin(); it != alt.end(); ++it) {
+              it->second.enumerate_variables_with(func);
+            }
+            return;
+          }
+          default: {
+            // Let the out-of-line function report the error.
+            return this->enumerate_variables(Variable_callback<FunctionT &>(func));
+          }
+        }
+      }
   };
 
 inline std::ostream & operator<<(std::ostream &os, const Value &value)
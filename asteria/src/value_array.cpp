@@ -0,0 +1,774 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "value_array.hpp"
+#include "value.hpp"
+#include "utilities.hpp"
+
+namespace Asteria {
+
+Value_array::~Value_array()
+  {
+  }
+
+Value_array::Value_array(const Value_array &) noexcept
+  = default;
+
+Value_array & Value_array::operator=(const Value_array &) noexcept
+  = default;
+
+Value_array::Value_array(Value_array &&) noexcept
+  = default;
+
+Value_array & Value_array::operator=(Value_array &&) noexcept
+  = default;
+
+  namespace {
+
+  inline Value_array::Mode do_mode_of(Value::Type type) noexcept
+    {
+      switch(rocket::weaken_enum(type)) {
+        case Value::type_integer: {
+          return Value_array::mode_integer;
+        }
+        case Value::type_real: {
+          return Value_array::mode_real;
+        }
+        default: {
+          return Value_array::mode_generic;
+        }
+      }
+    }
+
+  template<typename ElementT>
+    inline const ElementT * do_data(const Value_array::S_unboxed<ElementT> &alt) noexcept
+    {
+      return alt.elems.data() + alt.off;
+    }
+
+  template<typename ElementT>
+    inline Value_array::S_unboxed<ElementT> do_make_unboxed(Vector<ElementT> &&elems) noexcept
+    {
+      const auto len = elems.size();
+      return { std::move(elems), 0, len };
+    }
+
+  // Makes the view refer to the end of a buffer of its own, so its elements can be modified and appended in place.
+  // Elements before the view are dropped only if they outnumber the elements in it, so repeatedly erasing the first
+  // element and appending another takes amortized constant time.
+  template<typename ElementT>
+    Vector<ElementT> & do_materialize(Value_array::S_unboxed<ElementT> &alt)
+    {
+      if(!alt.elems.unique() || (alt.off + alt.len != alt.elems.size())) {
+        Vector<ElementT> elems(do_data(alt), do_data(alt) + alt.len);
+        alt.elems = std::move(elems);
+        alt.off = 0;
+      } else if(alt.off > alt.len) {
+        alt.elems.erase(alt.elems.begin(), alt.elems.begin() + static_cast<Diff>(alt.off));
+        alt.off = 0;
+      }
+      return alt.elems;
+    }
+
+  template<typename ElementT>
+    Persistent_vector<Value> do_box(const Value_array::S_unboxed<ElementT> &alt)
+    {
+      Persistent_vector<Value> res;
+      for(Size i = 0; i < alt.len; ++i) {
+        res.emplace_back(do_data(alt)[i]);
+      }
+      return res;
+    }
+
+  Value_array::S_unboxed<D_real> do_convert_to_reals(const D_integer *data, Size count)
+    {
+      Vector<D_real> res;
+      res.reserve(count);
+      for(Size i = 0; i < count; ++i) {
+        res.emplace_back(static_cast<D_real>(data[i]));
+      }
+      return do_make_unboxed(std::move(res));
+    }
+
+  // The loops below are written without data-dependent branches and with multiple accumulators,
+  // so they can be vectorized by the compiler.
+
+  D_integer do_sum(const D_integer *data, Size count)
+    {
+      // Each element is split into its high and low 32-bit halves, which are summed up separately as unsigned integers.
+      // Neither sum can overflow within a block of `0x7FFFFFFF` elements, so overflow is checked only once per block.
+      Sint64 hi_total = 0;
+      Uint64 lo_total = 0;
+      Size off = 0;
+      while(off != count) {
+        const auto n = rocket::min(count - off, Size(0x7FFFFFFF));
+        Uint64 hi = 0;
+        Uint64 lo = 0;
+        Uint64 neg = 0;
+        for(Size i = 0; i < n; ++i) {
+          const auto elem = static_cast<Uint64>(data[off + i]);
+          hi += elem >> 32;
+          lo += elem & 0xFFFFFFFF;
+          neg += elem >> 63;
+        }
+        // Every negative element has been offset by `2^64` above.
+        lo_total += lo;
+        hi_total = checked_add(hi_total, static_cast<Sint64>(hi + (lo_total >> 32)) - static_cast<Sint64>(neg << 32));
+        lo_total &= 0xFFFFFFFF;
+        off += n;
+      }
+      // The result is `hi_total * 2^32 + lo_total`, which fits in an `integer` only if `hi_total` fits in 32 bits.
+      if((hi_total < -0x80000000LL) || (hi_total > 0x7FFFFFFFLL)) {
+        ASTERIA_THROW_RUNTIME_ERROR("The sum of `", count, "` integers would result in overflow.");
+      }
+      return static_cast<D_integer>((static_cast<Uint64>(hi_total) << 32) | lo_total);
+    }
+
+  D_real do_sum(const D_real *data, Size count)
+    {
+      // N.B. The order of summation is unspecified.
+      D_real acc[4] = { 0, 0, 0, 0 };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] += data[i + k];
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] += data[i];
+      }
+      return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+  D_integer do_min(const D_integer *data, Size count)
+    {
+      ROCKET_ASSERT(count != 0);
+      D_integer acc[4] = { data[0], data[0], data[0], data[0] };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] = (data[i + k] < acc[k]) ? data[i + k] : acc[k];
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] = (data[i] < acc[0]) ? data[i] : acc[0];
+      }
+      return rocket::min(rocket::min(acc[0], acc[1]), rocket::min(acc[2], acc[3]));
+    }
+
+  D_integer do_max(const D_integer *data, Size count)
+    {
+      ROCKET_ASSERT(count != 0);
+      D_integer acc[4] = { data[0], data[0], data[0], data[0] };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] = (data[i + k] > acc[k]) ? data[i + k] : acc[k];
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] = (data[i] > acc[0]) ? data[i] : acc[0];
+      }
+      return rocket::max(rocket::max(acc[0], acc[1]), rocket::max(acc[2], acc[3]));
+    }
+
+  D_real do_min(const D_real *data, Size count)
+    {
+      // NaNs are ignored unless all elements are NaNs.
+      ROCKET_ASSERT(count != 0);
+      D_real acc[4] = { data[0], data[0], data[0], data[0] };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] = std::fmin(acc[k], data[i + k]);
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] = std::fmin(acc[0], data[i]);
+      }
+      return std::fmin(std::fmin(acc[0], acc[1]), std::fmin(acc[2], acc[3]));
+    }
+
+  D_real do_max(const D_real *data, Size count)
+    {
+      // NaNs are ignored unless all elements are NaNs.
+      ROCKET_ASSERT(count != 0);
+      D_real acc[4] = { data[0], data[0], data[0], data[0] };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] = std::fmax(acc[k], data[i + k]);
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] = std::fmax(acc[0], data[i]);
+      }
+      return std::fmax(std::fmax(acc[0], acc[1]), std::fmax(acc[2], acc[3]));
+    }
+
+  void do_scale(D_integer *data, Size count, D_integer factor)
+    {
+      if(count == 0) {
+        return;
+      }
+      // If neither the minimum nor the maximum element overflows, no element overflows.
+      checked_multiply(do_min(data, count), factor);
+      checked_multiply(do_max(data, count), factor);
+      for(Size i = 0; i < count; ++i) {
+        data[i] *= factor;
+      }
+    }
+
+  void do_scale(D_real *data, Size count, D_real factor)
+    {
+      for(Size i = 0; i < count; ++i) {
+        data[i] *= factor;
+      }
+    }
+
+  D_integer do_dot(const D_integer *lhs, const D_integer *rhs, Size count)
+    {
+      // Every product has to be checked for overflow, so this loop cannot be vectorized.
+      D_integer acc = 0;
+      for(Size i = 0; i < count; ++i) {
+        acc = checked_add(acc, checked_multiply(lhs[i], rhs[i]));
+      }
+      return acc;
+    }
+
+  D_real do_dot(const D_real *lhs, const D_real *rhs, Size count)
+    {
+      // N.B. The order of summation is unspecified.
+      D_real acc[4] = { 0, 0, 0, 0 };
+      Size i = 0;
+      for(; i + 4 <= count; i += 4) {
+        for(Size k = 0; k < 4; ++k) {
+          acc[k] += lhs[i + k] * rhs[i + k];
+        }
+      }
+      for(; i < count; ++i) {
+        acc[0] += lhs[i] * rhs[i];
+      }
+      return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+  }
+
+void Value_array::do_check_opened() noexcept
+  {
+    if(this->m_opened == Size(-1)) {
+      return;
+    }
+    this->m_may_have_vars |= this->m_stor.as<Persistent_vector<Value>>()[this->m_opened].may_contain_variables();
+    this->m_opened = Size(-1);
+  }
+
+Persistent_vector<Value> & Value_array::do_generalize()
+  {
+    switch(this->mode()) {
+      case mode_generic: {
+        return this->m_stor.as<Persistent_vector<Value>>();
+      }
+      case mode_integer: {
+        auto elems = do_box(this->m_stor.as<S_unboxed<D_integer>>());
+        this->m_may_have_vars = false;
+        this->m_opened = Size(-1);
+        return this->m_stor.set(std::move(elems));
+      }
+      case mode_real: {
+        auto elems = do_box(this->m_stor.as<S_unboxed<D_real>>());
+        this->m_may_have_vars = false;
+        this->m_opened = Size(-1);
+        return this->m_stor.set(std::move(elems));
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value_array::Mode Value_array::do_adapt_to(const Value &value)
+  {
+    const auto mode = do_mode_of(value.type());
+    if(this->mode() == mode) {
+      return mode;
+    }
+    if(this->empty()) {
+      // Pick the best mode for the first element.
+      this->m_may_have_vars = false;
+      this->m_opened = Size(-1);
+      switch(mode) {
+        case mode_generic: {
+          this->m_stor.set(Persistent_vector<Value>());
+          break;
+        }
+        case mode_integer: {
+          this->m_stor.set(do_make_unboxed(Vector<D_integer>()));
+          break;
+        }
+        case mode_real: {
+          this->m_stor.set(do_make_unboxed(Vector<D_real>()));
+          break;
+        }
+        default: {
+          ASTERIA_TERMINATE("An unknown array mode enumeration `", mode, "` has been encountered.");
+        }
+      }
+      return mode;
+    }
+    this->do_generalize();
+    return mode_generic;
+  }
+
+Value_array Value_array::do_unbox() const
+  {
+    const auto qelems = this->opt<Persistent_vector<Value>>();
+    if(!qelems) {
+      return *this;
+    }
+    // Collect `integer`s. If a `real` is encountered, convert all elements to `real`s.
+    Vector<D_integer> ints;
+    Vector<D_real> reals;
+    bool integral = true;
+    for(auto it = qelems->begin(); it != qelems->end(); ++it) {
+      switch(rocket::weaken_enum(it->type())) {
+        case Value::type_integer: {
+          const auto &alt = it->check<D_integer>();
+          if(integral) {
+            ints.emplace_back(alt);
+            break;
+          }
+          reals.emplace_back(static_cast<D_real>(alt));
+          break;
+        }
+        case Value::type_real: {
+          const auto &alt = it->check<D_real>();
+          if(integral) {
+            reals = std::move(do_convert_to_reals(ints.data(), ints.size()).elems);
+            integral = false;
+          }
+          reals.emplace_back(alt);
+          break;
+        }
+        default: {
+          ASTERIA_THROW_RUNTIME_ERROR("The array element `", *it, "` is not a number.");
+        }
+      }
+    }
+    Value_array res;
+    if(integral) {
+      res.m_stor.set(do_make_unboxed(std::move(ints)));
+    } else {
+      res.m_stor.set(do_make_unboxed(std::move(reals)));
+    }
+    return res;
+  }
+
+bool Value_array::empty() const noexcept
+  {
+    return this->size() == 0;
+  }
+
+Size Value_array::size() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_generic: {
+        return this->m_stor.as<Persistent_vector<Value>>().size();
+      }
+      case mode_integer: {
+        return this->m_stor.as<S_unboxed<D_integer>>().len;
+      }
+      case mode_real: {
+        return this->m_stor.as<S_unboxed<D_real>>().len;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Size Value_array::max_size() const noexcept
+  {
+    // Any array may be converted to a generic one.
+    return Persistent_vector<Value>().max_size();
+  }
+
+void Value_array::clear() noexcept
+  {
+    switch(this->mode()) {
+      case mode_generic: {
+        this->m_stor.as<Persistent_vector<Value>>().clear();
+        this->m_may_have_vars = false;
+        this->m_opened = Size(-1);
+        return;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        alt.elems.clear();
+        alt.off = 0;
+        alt.len = 0;
+        return;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        alt.elems.clear();
+        alt.off = 0;
+        alt.len = 0;
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+void Value_array::reserve(Size res_arg)
+  {
+    switch(this->mode()) {
+      case mode_generic: {
+        this->m_stor.as<Persistent_vector<Value>>().reserve(res_arg);
+        return;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        auto &elems = do_materialize(alt);
+        elems.reserve(alt.off + res_arg);
+        return;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        auto &elems = do_materialize(alt);
+        elems.reserve(alt.off + res_arg);
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value Value_array::at(Size index) const
+  {
+    const auto size = this->size();
+    if(index >= size) {
+      ASTERIA_THROW_RUNTIME_ERROR("The subscript `", index, "` is out of range for an array of size `", size, "`.");
+    }
+    switch(this->mode()) {
+      case mode_generic: {
+        return this->m_stor.as<Persistent_vector<Value>>()[index];
+      }
+      case mode_integer: {
+        return do_data(this->m_stor.as<S_unboxed<D_integer>>())[index];
+      }
+      case mode_real: {
+        return do_data(this->m_stor.as<S_unboxed<D_real>>())[index];
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+bool Value_array::may_contain_variables() const noexcept
+  {
+    const auto qelems = this->opt<Persistent_vector<Value>>();
+    if(!qelems) {
+      return false;
+    }
+    if(this->m_may_have_vars) {
+      return true;
+    }
+    return (this->m_opened != Size(-1)) && (*qelems)[this->m_opened].may_contain_variables();
+  }
+
+Value & Value_array::mut(Size index)
+  {
+    auto &elems = this->do_generalize();
+    auto &elem = elems.mut(index);
+    // The element may be overwritten with anything, so it is checked when another one is handed out.
+    if(this->m_opened != index) {
+      this->do_check_opened();
+      this->m_opened = index;
+    }
+    return elem;
+  }
+
+void Value_array::set(Size index, Value value)
+  {
+    const auto size = this->size();
+    if(index >= size) {
+      ASTERIA_THROW_RUNTIME_ERROR("The subscript `", index, "` is out of range for an array of size `", size, "`.");
+    }
+    switch(this->do_adapt_to(value)) {
+      case mode_generic: {
+        if(this->m_opened == index) {
+          // The element is overwritten.
+          this->m_opened = Size(-1);
+        }
+        this->m_may_have_vars |= value.may_contain_variables();
+        this->m_stor.as<Persistent_vector<Value>>().mut(index) = std::move(value);
+        return;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        do_materialize(alt).mut(alt.off + index) = value.check<D_integer>();
+        return;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        do_materialize(alt).mut(alt.off + index) = value.check<D_real>();
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+void Value_array::push_back(Value value)
+  {
+    switch(this->do_adapt_to(value)) {
+      case mode_generic: {
+        this->m_may_have_vars |= value.may_contain_variables();
+        this->m_stor.as<Persistent_vector<Value>>().emplace_back(std::move(value));
+        return;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        do_materialize(alt).emplace_back(value.check<D_integer>());
+        alt.len += 1;
+        return;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        do_materialize(alt).emplace_back(value.check<D_real>());
+        alt.len += 1;
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+void Value_array::insert(Size index, Value value)
+  {
+    const auto size = this->size();
+    if(index > size) {
+      ASTERIA_THROW_RUNTIME_ERROR("The insertion position `", index, "` is out of range for an array of size `", size, "`.");
+    }
+    switch(this->do_adapt_to(value)) {
+      case mode_generic: {
+        this->do_check_opened();
+        this->m_may_have_vars |= value.may_contain_variables();
+        auto &elems = this->m_stor.as<Persistent_vector<Value>>();
+        elems.insert(elems.begin() + static_cast<Diff>(index), std::move(value));
+        return;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        auto &elems = do_materialize(alt);
+        elems.insert(elems.begin() + static_cast<Diff>(alt.off + index), value.check<D_integer>());
+        alt.len += 1;
+        return;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        auto &elems = do_materialize(alt);
+        elems.insert(elems.begin() + static_cast<Diff>(alt.off + index), value.check<D_real>());
+        alt.len += 1;
+        return;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+void Value_array::append(Size count)
+  {
+    if(count == 0) {
+      return;
+    }
+    this->do_generalize().append(count);
+  }
+
+void Value_array::prepend(Size count)
+  {
+    if(count == 0) {
+      return;
+    }
+    auto &elems = this->do_generalize();
+    this->do_check_opened();
+    elems.insert(elems.begin(), count);
+  }
+
+Value Value_array::erase(Size index)
+  {
+    const auto size = this->size();
+    if(index >= size) {
+      ASTERIA_THROW_RUNTIME_ERROR("The subscript `", index, "` is out of range for an array of size `", size, "`.");
+    }
+    switch(this->mode()) {
+      case mode_generic: {
+        this->do_check_opened();
+        auto &elems = this->m_stor.as<Persistent_vector<Value>>();
+        auto elem = std::move(elems.mut(index));
+        elems.erase(elems.begin() + static_cast<Diff>(index));
+        return elem;
+      }
+      case mode_integer: {
+        auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        const auto elem = do_data(alt)[index];
+        if(index == 0) {
+          // Erasing the first element only shrinks the view.
+          alt.off += 1;
+        } else {
+          auto &elems = do_materialize(alt);
+          elems.erase(elems.begin() + static_cast<Diff>(alt.off + index));
+        }
+        alt.len -= 1;
+        return elem;
+      }
+      case mode_real: {
+        auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        const auto elem = do_data(alt)[index];
+        if(index == 0) {
+          // Erasing the first element only shrinks the view.
+          alt.off += 1;
+        } else {
+          auto &elems = do_materialize(alt);
+          elems.erase(elems.begin() + static_cast<Diff>(alt.off + index));
+        }
+        alt.len -= 1;
+        return elem;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value_array Value_array::subarray(Size index, Size count) const
+  {
+    const auto size = this->size();
+    if(index > size) {
+      ASTERIA_THROW_RUNTIME_ERROR("The subarray position `", index, "` is out of range for an array of size `", size, "`.");
+    }
+    const auto rcount = rocket::min(count, size - index);
+    Value_array res;
+    switch(this->mode()) {
+      case mode_generic: {
+        // Nodes of the tree that are not cut are shared.
+        const auto &elems = this->m_stor.as<Persistent_vector<Value>>();
+        res.m_stor.set(elems.subvector(index, rcount));
+        res.m_may_have_vars = this->may_contain_variables();
+        return res;
+      }
+      case mode_integer: {
+        // Create a view of the same buffer.
+        const auto &alt = this->m_stor.as<S_unboxed<D_integer>>();
+        res.m_stor.set(S_unboxed<D_integer>{ alt.elems, alt.off + index, rcount });
+        return res;
+      }
+      case mode_real: {
+        // Create a view of the same buffer.
+        const auto &alt = this->m_stor.as<S_unboxed<D_real>>();
+        res.m_stor.set(S_unboxed<D_real>{ alt.elems, alt.off + index, rcount });
+        return res;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown array mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value Value_array::sum() const
+  {
+    const auto unboxed = this->do_unbox();
+    const auto qints = unboxed.opt<S_unboxed<D_integer>>();
+    if(qints) {
+      return do_sum(do_data(*qints), qints->len);
+    }
+    const auto &reals = unboxed.m_stor.as<S_unboxed<D_real>>();
+    return do_sum(do_data(reals), reals.len);
+  }
+
+Value Value_array::min() const
+  {
+    const auto unboxed = this->do_unbox();
+    if(unboxed.empty()) {
+      return { };
+    }
+    const auto qints = unboxed.opt<S_unboxed<D_integer>>();
+    if(qints) {
+      return do_min(do_data(*qints), qints->len);
+    }
+    const auto &reals = unboxed.m_stor.as<S_unboxed<D_real>>();
+    return do_min(do_data(reals), reals.len);
+  }
+
+Value Value_array::max() const
+  {
+    const auto unboxed = this->do_unbox();
+    if(unboxed.empty()) {
+      return { };
+    }
+    const auto qints = unboxed.opt<S_unboxed<D_integer>>();
+    if(qints) {
+      return do_max(do_data(*qints), qints->len);
+    }
+    const auto &reals = unboxed.m_stor.as<S_unboxed<D_real>>();
+    return do_max(do_data(reals), reals.len);
+  }
+
+void Value_array::scale(const Value &factor)
+  {
+    if(!rocket::is_any_of(factor.type(), { Value::type_integer, Value::type_real })) {
+      ASTERIA_THROW_RUNTIME_ERROR("An array cannot be scaled by `", factor, "`, which is not a number.");
+    }
+    if(this->mode() == mode_generic) {
+      *this = this->do_unbox();
+    }
+    const auto qints = this->m_stor.get<S_unboxed<D_integer>>();
+    if(qints && (factor.type() == Value::type_integer)) {
+      auto &elems = do_materialize(*qints);
+      do_scale(elems.mut_data() + qints->off, qints->len, factor.check<D_integer>());
+      return;
+    }
+    // Scaling by a `real` yields `real`s.
+    if(qints) {
+      this->m_stor.set(do_convert_to_reals(do_data(*qints), qints->len));
+    }
+    auto &reals = this->m_stor.as<S_unboxed<D_real>>();
+    auto &elems = do_materialize(reals);
+    const auto qfint = factor.opt<D_integer>();
+    do_scale(elems.mut_data() + reals.off, reals.len, qfint ? static_cast<D_real>(*qfint) : factor.check<D_real>());
+  }
+
+Value Value_array::dot(const Value_array &other) const
+  {
+    if(this->size() != other.size()) {
+      ASTERIA_THROW_RUNTIME_ERROR("The dot product of arrays of different sizes (`", this->size(), "` and `", other.size(), "`) is undefined.");
+    }
+    auto unboxed_lhs = this->do_unbox();
+    auto unboxed_rhs = other.do_unbox();
+    const auto qints_lhs = unboxed_lhs.opt<S_unboxed<D_integer>>();
+    const auto qints_rhs = unboxed_rhs.opt<S_unboxed<D_integer>>();
+    if(qints_lhs && qints_rhs) {
+      return do_dot(do_data(*qints_lhs), do_data(*qints_rhs), qints_lhs->len);
+    }
+    // If either operand contains `real`s, the other one is converted to `real`s.
+    if(qints_lhs) {
+      unboxed_lhs.m_stor.set(do_convert_to_reals(do_data(*qints_lhs), qints_lhs->len));
+    }
+    if(qints_rhs) {
+      unboxed_rhs.m_stor.set(do_convert_to_reals(do_data(*qints_rhs), qints_rhs->len));
+    }
+    const auto &reals_lhs = unboxed_lhs.m_stor.as<S_unboxed<D_real>>();
+    const auto &reals_rhs = unboxed_rhs.m_stor.as<S_unboxed<D_real>>();
+    return do_dot(do_data(reals_lhs), do_data(reals_rhs), reals_lhs.len);
+  }
+
+}
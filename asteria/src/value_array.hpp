@@ -0,0 +1,114 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_VALUE_ARRAY_HPP_
+#define ASTERIA_VALUE_ARRAY_HPP_
+
+#include "fwd.hpp"
+#include "rocket/variant.hpp"
+
+namespace Asteria {
+
+// Arrays consisting solely of `integer`s or solely of `real`s are stored unboxed in contiguous buffers.
+// Such an array is converted to a generic one transparently when an element of another type is stored into it.
+class Value_array
+  {
+  public:
+    enum Mode : Uint8
+      {
+        mode_generic  = 0,
+        mode_integer  = 1,
+        mode_real     = 2,
+      };
+    // An unboxed array is a view of `len` elements starting at `off` in `elems`, which may be shared with other arrays.
+    // The elements are copied into a new buffer when the array is modified.
+    template<typename ElementT>
+      struct S_unboxed
+      {
+        Vector<ElementT> elems;
+        Size off;
+        Size len;
+      };
+    using Variant = rocket::variant<
+      ROCKET_CDR(
+        , Persistent_vector<Value>  // 0,
+        , S_unboxed<D_integer>      // 1,
+        , S_unboxed<D_real>         // 2,
+      )>;
+
+  private:
+    Variant m_stor;
+    // This is set when a value that may contain variables is stored into a generic array. It is cleared only when the
+    // array is emptied. Unboxed arrays never contain variables.
+    bool m_may_have_vars;
+    // This is the index of the element of a generic array that was handed out for modification last, or `Size(-1)` if
+    // there is none. As it may be overwritten with anything, it is checked along with `m_may_have_vars`, until another
+    // element is handed out or elements are shifted.
+    Size m_opened;
+
+  public:
+    Value_array() noexcept
+      : m_stor(),  // Initialize to an empty generic array.
+        m_may_have_vars(false), m_opened(Size(-1))
+      {
+      }
+    ~Value_array();
+
+    Value_array(const Value_array &) noexcept;
+    Value_array & operator=(const Value_array &) noexcept;
+    Value_array(Value_array &&) noexcept;
+    Value_array & operator=(Value_array &&) noexcept;
+
+  private:
+    void do_check_opened() noexcept;
+    Persistent_vector<Value> & do_generalize();
+    Mode do_adapt_to(const Value &value);
+    Value_array do_unbox() const;
+
+  public:
+    Mode mode() const noexcept
+      {
+        return Mode(this->m_stor.index());
+      }
+    template<typename StorT>
+      const StorT * opt() const noexcept
+      {
+        return this->m_stor.get<StorT>();
+      }
+    // If this function returns `false`, no variable is reachable from this array, so it cannot be part of a cycle.
+    bool may_contain_variables() const noexcept;
+
+    bool empty() const noexcept;
+    Size size() const noexcept;
+    Size max_size() const noexcept;
+    void clear() noexcept;
+    void reserve(Size res_arg);
+
+    Value at(Size index) const;
+    // This function converts the array to a generic one.
+    Value & mut(Size index);
+    // This function converts the array to a generic one only if `value` cannot be stored unboxed.
+    void set(Size index, Value value);
+
+    void push_back(Value value);
+    void insert(Size index, Value value);
+    // These functions fill the array with `null`s.
+    void append(Size count);
+    void prepend(Size count);
+    Value erase(Size index);
+    // The result shares elements with this array.
+    Value_array subarray(Size index, Size count = Size(-1)) const;
+
+    // These functions require that all elements be `integer`s or `real`s.
+    // If all elements are `integer`s, the result is an `integer`. Otherwise, it is a `real`.
+    Value sum() const;
+    // These functions return `null` if the array is empty.
+    Value min() const;
+    Value max() const;
+    void scale(const Value &factor);
+    Value dot(const Value_array &other) const;
+  };
+
+}
+
+#endif
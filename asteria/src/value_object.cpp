@@ -0,0 +1,302 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "value_object.hpp"
+#include "value.hpp"
+#include "utilities.hpp"
+
+namespace Asteria {
+
+Value_object::~Value_object()
+  {
+  }
+
+Value_object::Value_object(const Value_object &) noexcept
+  = default;
+
+Value_object & Value_object::operator=(const Value_object &) noexcept
+  = default;
+
+Value_object::Value_object(Value_object &&) noexcept
+  = default;
+
+Value_object & Value_object::operator=(Value_object &&) noexcept
+  = default;
+
+Persistent_dictionary<Value> & Value_object::do_make_trie()
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        const auto &flat = this->m_stor.as<Dictionary<Value>>();
+        Persistent_dictionary<Value> trie;
+        for(auto it = flat.begin(); it != flat.end(); ++it) {
+          trie.try_emplace(it->first, it->second);
+        }
+        return this->m_stor.set(std::move(trie));
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+std::pair<Value_object::iterator, bool> Value_object::do_try_emplace(const String &key, Size hash)
+  {
+    auto qflat = this->m_stor.get<Dictionary<Value>>();
+    if(qflat && (qflat->size() >= flat_size_limit) && (qflat->find(key, hash) == qflat->end())) {
+      // The object has outgrown its flat table.
+      qflat = nullptr;
+      this->do_make_trie();
+    }
+    if(qflat) {
+      // Allocate a table of the maximum size up front, so it stays in small mode, where elements are stored in-place
+      // and are never relocated.
+      qflat->reserve(flat_size_limit);
+      const auto result = qflat->try_emplace_with_hash(key, hash);
+      return std::make_pair(iterator(result.first), result.second);
+    }
+    const auto result = this->m_stor.as<Persistent_dictionary<Value>>().try_emplace_with_hash(key, hash);
+    return std::make_pair(iterator(result.first), result.second);
+  }
+
+long Value_object::use_count() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<Dictionary<Value>>().use_count();
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>().use_count();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+const void * Value_object::storage_id() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<Dictionary<Value>>().storage_id();
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>().root_id();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+bool Value_object::has_shared_subtrees() const noexcept
+  {
+    // A flat table is shared as a whole or not at all.
+    const auto qtrie = this->m_stor.get<Persistent_dictionary<Value>>();
+    return qtrie && qtrie->has_shared_subtrees();
+  }
+
+Value_object::const_iterator Value_object::begin() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return const_iterator(this->m_stor.as<Dictionary<Value>>().begin());
+      }
+      case mode_trie: {
+        return const_iterator(this->m_stor.as<Persistent_dictionary<Value>>().begin());
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value_object::const_iterator Value_object::end() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return const_iterator(this->m_stor.as<Dictionary<Value>>().end());
+      }
+      case mode_trie: {
+        return const_iterator(this->m_stor.as<Persistent_dictionary<Value>>().end());
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+bool Value_object::empty() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<Dictionary<Value>>().empty();
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>().empty();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Size Value_object::size() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<Dictionary<Value>>().size();
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>().size();
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+void Value_object::clear() noexcept
+  {
+    const auto qflat = this->m_stor.get<Dictionary<Value>>();
+    if(qflat) {
+      qflat->clear();
+    } else {
+      this->m_stor.set(Dictionary<Value>());
+    }
+    this->m_may_have_vars = false;
+  }
+
+Value_object::const_iterator Value_object::find(const String &key) const
+  {
+    return this->find(key, String::hash()(key));
+  }
+
+Value_object::const_iterator Value_object::find(const String &key, Size hash) const
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return const_iterator(this->m_stor.as<Dictionary<Value>>().find(key, hash));
+      }
+      case mode_trie: {
+        return const_iterator(this->m_stor.as<Persistent_dictionary<Value>>().find(key, hash));
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+const Value & Value_object::at(const String &key) const
+  {
+    const auto rit = this->find(key);
+    if(rit == this->end()) {
+      ASTERIA_THROW_RUNTIME_ERROR("The key `", key, "` was not found in this object.");
+    }
+    return rit->second;
+  }
+
+Value & Value_object::mut(const String &key)
+  {
+    const auto rit = this->find_mut(key, String::hash()(key));
+    if(rit == this->end()) {
+      ASTERIA_THROW_RUNTIME_ERROR("The key `", key, "` was not found in this object.");
+    }
+    return rit->second;
+  }
+
+Value_object::iterator Value_object::find_mut(const String &key, Size hash)
+  {
+    iterator rit;
+    switch(this->mode()) {
+      case mode_flat: {
+        auto &flat = this->m_stor.as<Dictionary<Value>>();
+        const auto fit = flat.find_mut(key, hash);
+        if(fit == flat.end()) {
+          return iterator(fit);
+        }
+        rit = iterator(fit);
+        break;
+      }
+      case mode_trie: {
+        auto &trie = this->m_stor.as<Persistent_dictionary<Value>>();
+        const auto tit = trie.find_mut(key, hash);
+        if(tit == trie.end()) {
+          return iterator(tit);
+        }
+        rit = iterator(tit);
+        break;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+    // The member may be overwritten with anything.
+    this->m_may_have_vars = true;
+    return rit;
+  }
+
+std::pair<Value_object::iterator, bool> Value_object::try_emplace_with_hash(const String &key, Size hash)
+  {
+    const auto result = this->do_try_emplace(key, hash);
+    // The member may be overwritten with anything.
+    this->m_may_have_vars = true;
+    return result;
+  }
+
+bool Value_object::try_emplace(const String &key, Value value)
+  {
+    const auto result = this->do_try_emplace(key, String::hash()(key));
+    if(result.second) {
+      this->m_may_have_vars |= value.may_contain_variables();
+      result.first->second = std::move(value);
+    }
+    return result.second;
+  }
+
+void Value_object::insert_or_assign(const String &key, Value value)
+  {
+    this->insert_or_assign_with_hash(key, String::hash()(key), std::move(value));
+  }
+
+void Value_object::insert_or_assign_with_hash(const String &key, Size hash, Value value)
+  {
+    this->m_may_have_vars |= value.may_contain_variables();
+    this->do_try_emplace(key, hash).first->second = std::move(value);
+  }
+
+Value_object::iterator Value_object::erase(const_iterator pos)
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return iterator(this->m_stor.as<Dictionary<Value>>().erase(pos.m_flat));
+      }
+      case mode_trie: {
+        return iterator(this->m_stor.as<Persistent_dictionary<Value>>().erase(pos.m_trie));
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+bool Value_object::erase(const String &key)
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<Dictionary<Value>>().erase(key);
+      }
+      case mode_trie: {
+        return this->m_stor.as<Persistent_dictionary<Value>>().erase(key);
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown object mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+}
@@ -0,0 +1,186 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_VALUE_OBJECT_HPP_
+#define ASTERIA_VALUE_OBJECT_HPP_
+
+#include "fwd.hpp"
+#include "rocket/variant.hpp"
+
+namespace Asteria {
+
+// Small objects are stored in flat hash tables, which are copied as a whole when they are modified while shared.
+// An object that grows beyond `flat_size_limit` members is moved into a persistent hash trie, where such a modification
+// copies only the nodes on the path to the member. It is moved back only when it is emptied.
+// The limit matches the capacity of small `cow_hashmap`s, which store elements in-place and search for keys linearly,
+// as leaves of hash tries do.
+class Value_object
+  {
+  public:
+    enum Mode : Uint8
+      {
+        mode_flat  = 0,
+        mode_trie  = 1,
+      };
+    enum : Size
+      {
+        flat_size_limit  = 8,
+      };
+    using Variant = rocket::variant<
+      ROCKET_CDR(
+        , Dictionary<Value>             // 0,
+        , Persistent_dictionary<Value>  // 1,
+      )>;
+
+    // An iterator of either storage. Only the one that matches `mode` is meaningful.
+    template<typename FlatT, typename TrieT>
+      class Basic_iterator
+      {
+        friend Value_object;
+        template<typename, typename>
+          friend class Basic_iterator;
+
+      public:
+        using iterator_category  = std::forward_iterator_tag;
+        using value_type         = typename std::iterator_traits<FlatT>::value_type;
+        using pointer            = typename std::iterator_traits<FlatT>::pointer;
+        using reference          = typename std::iterator_traits<FlatT>::reference;
+        using difference_type    = typename std::iterator_traits<FlatT>::difference_type;
+
+      private:
+        Mode m_mode;
+        FlatT m_flat;
+        TrieT m_trie;
+
+      private:
+        explicit Basic_iterator(FlatT flat) noexcept
+          : m_mode(mode_flat), m_flat(flat), m_trie()
+          {
+          }
+        explicit Basic_iterator(TrieT trie) noexcept
+          : m_mode(mode_trie), m_flat(), m_trie(trie)
+          {
+          }
+
+      public:
+        Basic_iterator() noexcept
+          : m_mode(mode_flat), m_flat(), m_trie()
+          {
+          }
+        template<typename XflatT, typename XtrieT, typename std::enable_if<std::is_convertible<XflatT, FlatT>::value>::type * = nullptr>
+          Basic_iterator(const Basic_iterator<XflatT, XtrieT> &other) noexcept
+          : m_mode(other.m_mode), m_flat(other.m_flat), m_trie(other.m_trie)
+          {
+          }
+
+      public:
+        reference operator*() const noexcept
+          {
+            return (this->m_mode == mode_flat) ? *(this->m_flat) : *(this->m_trie);
+          }
+        pointer operator->() const noexcept
+          {
+            return (this->m_mode == mode_flat) ? this->m_flat.operator->() : this->m_trie.operator->();
+          }
+        Basic_iterator & operator++()
+          {
+            if(this->m_mode == mode_flat) {
+              ++(this->m_flat);
+            } else {
+              ++(this->m_trie);
+            }
+            return *this;
+          }
+        Basic_iterator operator++(int)
+          {
+            auto res = *this;
+            ++*this;
+            return res;
+          }
+
+        template<typename XflatT, typename XtrieT>
+          bool operator==(const Basic_iterator<XflatT, XtrieT> &other) const noexcept
+          {
+            ROCKET_ASSERT(this->m_mode == other.m_mode);
+            return (this->m_mode == mode_flat) ? (this->m_flat == other.m_flat) : (this->m_trie == other.m_trie);
+          }
+        template<typename XflatT, typename XtrieT>
+          bool operator!=(const Basic_iterator<XflatT, XtrieT> &other) const noexcept
+          {
+            return !(*this == other);
+          }
+      };
+
+    using const_iterator = Basic_iterator<Dictionary<Value>::const_iterator, Persistent_dictionary<Value>::const_iterator>;
+    using iterator = Basic_iterator<Dictionary<Value>::iterator, Persistent_dictionary<Value>::iterator>;
+
+  private:
+    Variant m_stor;
+    // This is set when a value that may contain variables is stored, or when a member is handed out for modification.
+    // It is cleared only when the object is emptied.
+    bool m_may_have_vars;
+
+  public:
+    Value_object() noexcept
+      : m_stor(), m_may_have_vars(false)
+      {
+      }
+    ~Value_object();
+
+    Value_object(const Value_object &) noexcept;
+    Value_object & operator=(const Value_object &) noexcept;
+    Value_object(Value_object &&) noexcept;
+    Value_object & operator=(Value_object &&) noexcept;
+
+  private:
+    Persistent_dictionary<Value> & do_make_trie();
+    std::pair<iterator, bool> do_try_emplace(const String &key, Size hash);
+
+  public:
+    // If this function returns `false`, no variable is reachable from this object, so it cannot be part of a cycle.
+    bool may_contain_variables() const noexcept
+      {
+        return this->m_may_have_vars;
+      }
+
+    Mode mode() const noexcept
+      {
+        return Mode(this->m_stor.index());
+      }
+    template<typename StorT>
+      const StorT * opt() const noexcept
+      {
+        return this->m_stor.get<StorT>();
+      }
+    // These functions describe the storage, which may be shared with other objects.
+    long use_count() const noexcept;
+    const void * storage_id() const noexcept;
+    bool has_shared_subtrees() const noexcept;
+
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+    bool empty() const noexcept;
+    Size size() const noexcept;
+    void clear() noexcept;
+
+    const_iterator find(const String &key) const;
+    const_iterator find(const String &key, Size hash) const;
+    const Value & at(const String &key) const;
+
+    // These functions return members that may be modified.
+    Value & mut(const String &key);
+    iterator find_mut(const String &key, Size hash);
+    std::pair<iterator, bool> try_emplace_with_hash(const String &key, Size hash);
+
+    // This function returns `true` if a new member has been inserted.
+    bool try_emplace(const String &key, Value value);
+    void insert_or_assign(const String &key, Value value);
+    // `hash` shall be the hash value of `key`, as if it was computed by `String::hash()(key)`.
+    void insert_or_assign_with_hash(const String &key, Size hash, Value value);
+    iterator erase(const_iterator pos);
+    bool erase(const String &key);
+  };
+
+}
+
+#endif
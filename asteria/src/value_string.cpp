@@ -0,0 +1,138 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "value_string.hpp"
+#include "utilities.hpp"
+
+namespace Asteria {
+
+Value_string::~Value_string()
+  {
+  }
+
+Value_string::Value_string(const Value_string &) noexcept
+  = default;
+
+Value_string & Value_string::operator=(const Value_string &) noexcept
+  = default;
+
+Value_string::Value_string(Value_string &&) noexcept
+  = default;
+
+Value_string & Value_string::operator=(Value_string &&) noexcept
+  = default;
+
+const String & Value_string::flatten() const
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<String>();
+      }
+      case mode_rope: {
+        const auto &alt = this->m_stor.as<S_rope>();
+        // If this rope uses the whole buffer, the characters are shared rather than copied.
+        auto str = alt.buf->chars.substr(alt.off, alt.len);
+        return this->m_stor.set(std::move(str));
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown string mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Size Value_string::size() const noexcept
+  {
+    switch(this->mode()) {
+      case mode_flat: {
+        return this->m_stor.as<String>().size();
+      }
+      case mode_rope: {
+        return this->m_stor.as<S_rope>().len;
+      }
+      default: {
+        ASTERIA_TERMINATE("An unknown string mode enumeration `", this->mode(), "` has been encountered.");
+      }
+    }
+  }
+
+Value_string & Value_string::append(const Value_string &other)
+  {
+    // N.B. `other` may be `*this`, so read it before this string is modified.
+    const auto str_add = other.flatten();
+    if(str_add.empty()) {
+      return *this;
+    }
+    const auto qstr = this->m_stor.get<String>();
+    if(qstr && qstr->unique()) {
+      // The string is not shared, so append characters in place.
+      qstr->append(str_add);
+      return *this;
+    }
+    const auto len_old = this->size();
+    auto qrope = this->m_stor.get<S_rope>();
+    if(!qrope || (qrope->off + qrope->len != qrope->buf->chars.size())) {
+      // Characters following the range belong to another rope, so they cannot be overwritten.
+      // Copy the range into a new buffer.
+      const auto data_old = qrope ? (qrope->buf->chars.data() + qrope->off) : this->m_stor.as<String>().data();
+      auto buf = rocket::make_refcounted<S_rope_buffer>();
+      buf->chars.reserve(len_old + str_add.size());
+      buf->chars.append(data_old, len_old);
+      qrope = &(this->m_stor.set(S_rope { std::move(buf), 0, len_old }));
+    }
+    qrope->buf->chars.append(str_add);
+    qrope->len = qrope->buf->chars.size() - qrope->off;
+    return *this;
+  }
+
+Value_string & Value_string::repeat(Size count)
+  {
+    if(count == 0) {
+      this->m_stor.set(String());
+      return *this;
+    }
+    this->flatten();
+    auto &str = this->m_stor.as<String>();
+    const auto len_new = str.size() * count;
+    // If the string is shared, a new one is allocated. Otherwise, its capacity is increased in place.
+    str.reserve(len_new);
+    // Double the characters until the rest can be appended at once.
+    while(str.size() < len_new) {
+      str.append(str.data(), rocket::min(str.size(), len_new - str.size()));
+    }
+    return *this;
+  }
+
+Value_string Value_string::substr(Size pos, Size n) const
+  {
+    const auto len = this->size();
+    if(pos > len) {
+      ASTERIA_THROW_RUNTIME_ERROR("The substring position `", pos, "` is out of range for a string of length `", len, "`.");
+    }
+    const auto rlen = rocket::min(n, len - pos);
+    if(rlen == len) {
+      return *this;
+    }
+    Value_string res;
+    if(rlen == 0) {
+      return res;
+    }
+    const auto qrope = this->m_stor.get<S_rope>();
+    if(rlen <= flat_substr_limit) {
+      // Copying a few characters is cheaper than allocating a buffer for them.
+      const auto data = qrope ? (qrope->buf->chars.data() + qrope->off) : this->m_stor.as<String>().data();
+      res.m_stor.set(String(data + pos, rlen));
+      return res;
+    }
+    if(qrope) {
+      res.m_stor.set(S_rope { qrope->buf, qrope->off + pos, rlen });
+      return res;
+    }
+    // The buffer shares characters with this string.
+    auto buf = rocket::make_refcounted<S_rope_buffer>();
+    buf->chars = this->m_stor.as<String>();
+    res.m_stor.set(S_rope { std::move(buf), pos, rlen });
+    return res;
+  }
+
+}
@@ -0,0 +1,133 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_VALUE_STRING_HPP_
+#define ASTERIA_VALUE_STRING_HPP_
+
+#include "fwd.hpp"
+#include "rocket/variant.hpp"
+#include "rocket/refcounted_ptr.hpp"
+
+namespace Asteria {
+
+// Strings that result from concatenation are stored as ropes, which are flattened when their characters are inspected.
+// This makes repeated concatenation onto the same string take amortized linear time. Substrings are stored as ropes,
+// too, so taking one takes constant time, unless they are short enough to be copied.
+class Value_string
+  {
+  public:
+    enum Mode : Uint8
+      {
+        mode_flat  = 0,
+        mode_rope  = 1,
+      };
+    enum : Size
+      {
+        // Substrings no longer than this are copied into flat strings, rather than keeping the whole buffer alive.
+        flat_substr_limit  = 32,
+      };
+    // Characters are appended to a buffer which may be shared by multiple ropes, each of which uses a range of it.
+    // Only a rope whose range ends at the end of the buffer can append characters in place.
+    struct S_rope_buffer : rocket::refcounted_base<S_rope_buffer>
+      {
+        String chars;
+      };
+    struct S_rope
+      {
+        rocket::refcounted_ptr<S_rope_buffer> buf;
+        Size off;
+        Size len;
+      };
+    using Variant = rocket::variant<
+      ROCKET_CDR(
+        , String  // 0,
+        , S_rope  // 1,
+      )>;
+
+  private:
+    // This has to be `mutable` because ropes are flattened in `const` member functions.
+    mutable Variant m_stor;
+
+  public:
+    Value_string() noexcept
+      : m_stor()  // Initialize to an empty flat string.
+      {
+      }
+    Value_string(String str) noexcept
+      : m_stor(std::move(str))
+      {
+      }
+    Value_string(String::shallow sh) noexcept
+      : m_stor(String(sh))
+      {
+      }
+    explicit Value_string(const char *s)
+      : m_stor(String(s))
+      {
+      }
+    ~Value_string();
+
+    Value_string(const Value_string &) noexcept;
+    Value_string & operator=(const Value_string &) noexcept;
+    Value_string(Value_string &&) noexcept;
+    Value_string & operator=(Value_string &&) noexcept;
+
+  public:
+    Mode mode() const noexcept
+      {
+        return Mode(this->m_stor.index());
+      }
+    // This function converts the string to a flat one.
+    const String & flatten() const;
+    operator const String & () const
+      {
+        return this->flatten();
+      }
+
+    bool empty() const noexcept
+      {
+        return this->size() == 0;
+      }
+    Size size() const noexcept;
+    const char * data() const
+      {
+        return this->flatten().data();
+      }
+    const char * c_str() const
+      {
+        return this->flatten().c_str();
+      }
+    int compare(const Value_string &other) const
+      {
+        return this->flatten().compare(other.flatten());
+      }
+
+    // If this string is flat and not shared, characters are appended in place.
+    // Otherwise, this function converts the string to a rope, unless `other` is empty.
+    Value_string & append(const Value_string &other);
+    // The characters are repeated `count` times. The caller shall ensure the result is not too long to be allocated.
+    // If this string is flat and not shared, characters are appended in place.
+    Value_string & repeat(Size count);
+    // The result is a rope that shares characters with this string, unless it is no longer than `flat_substr_limit`.
+    Value_string substr(Size pos, Size n = Size(-1)) const;
+  };
+
+template<typename OtherT>
+  inline bool operator==(const Value_string &lhs, const OtherT &rhs)
+  {
+    return lhs.flatten() == rhs;
+  }
+template<typename OtherT>
+  inline bool operator!=(const Value_string &lhs, const OtherT &rhs)
+  {
+    return lhs.flatten() != rhs;
+  }
+
+inline std::ostream & operator<<(std::ostream &os, const Value_string &str)
+  {
+    return os <<str.flatten();
+  }
+
+}
+
+#endif
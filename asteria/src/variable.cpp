@@ -3,12 +3,32 @@
 
 #include "precompiled.hpp"
 #include "variable.hpp"
+#include "variable_list.hpp"
+#include "collector.hpp"
 #include "utilities.hpp"
 
 namespace Asteria {
 
 Variable::~Variable()
   {
+    // Only a list that holds no references may contain a variable that is being destroyed.
+    if(this->m_list_opt) {
+      ROCKET_ASSERT(this->m_list_opt->is_weak());
+      this->m_list_opt->erase(*this);
+    }
+  }
+
+Uint64 Variable::do_make_stamp() noexcept
+  {
+    // Each thread reserves a block of stamps at a time, so the shared counter is rarely touched.
+    // N.B. Zero is never returned.
+    static std::atomic<Uint64> s_next(1);
+    static thread_local Uint64 t_next, t_end;
+    if(t_next == t_end) {
+      t_next = s_next.fetch_add(0x10000, std::memory_order_relaxed);
+      t_end = t_next + 0x10000;
+    }
+    return t_next++;
   }
 
 [[noreturn]] void Variable::do_throw_immutable() const
@@ -16,6 +36,21 @@ Variable::~Variable()
     ASTERIA_THROW_RUNTIME_ERROR("This variable having value `", this->m_value, "` is immutable and cannot be modified.");
   }
 
+void Variable::do_write_barrier()
+  {
+    this->m_coll_opt->write_barrier(*this);
+  }
+
+void Variable::do_unpark()
+  {
+    this->m_park_opt->unpark_variable(*this);
+  }
+
+void Variable::do_buffer() noexcept
+  {
+    this->m_cand_opt->buffer_candidate(*this);
+  }
+
 void Variable::enumerate_variables(const Abstract_variable_callback &callback) const
   {
     this->m_value.enumerate_variables(callback);
@@ -6,25 +6,44 @@
 
 #include "fwd.hpp"
 #include "value.hpp"
+#include "variable_pool.hpp"
 #include "rocket/refcounted_ptr.hpp"
 
 namespace Asteria {
 
-class Variable : public rocket::refcounted_base<Variable>
+class Variable : public rocket::refcounted_base<Variable, Variable_deleter>
   {
+    friend Variable_list;
+
   private:
     Value m_value;
     bool m_immutable;
+    bool m_buffered;  // This is set if this variable has been buffered by the collector that `m_cand_opt` points to.
+    Uint64 m_stamp;
     long m_gcref;  // This is uninitialized by default.
+    // If a collection that is examining this variable is in progress, this points to the collector.
+    Collector *m_coll_opt;
+    // If this variable has been untracked because its value cannot form a cycle, this points to the collector that
+    // will track it again when it may.
+    Collector *m_park_opt;
+    // If this is set, this variable is buffered by that collector as a possible root of a cycle when a reference to it
+    // is dropped.
+    Collector *m_cand_opt;
+    // These are maintained by `Variable_list`. The list also serves as the generation tag.
+    Variable_list *m_list_opt;
+    Variable *m_list_prev;
+    Variable *m_list_next;
 
   public:
     Variable()
-      : m_value(), m_immutable(false)
+      : m_value(), m_immutable(false), m_buffered(false), m_stamp(do_make_stamp()), m_coll_opt(nullptr), m_park_opt(nullptr), m_cand_opt(nullptr),
+        m_list_opt(nullptr), m_list_prev(nullptr), m_list_next(nullptr)
       {
       }
     template<typename XvalueT, typename std::enable_if<std::is_constructible<Value, XvalueT &&>::value>::type * = nullptr>
       Variable(XvalueT &&value, bool immutable)
-      : m_value(std::forward<XvalueT>(value)), m_immutable(immutable)
+      : m_value(std::forward<XvalueT>(value)), m_immutable(immutable), m_buffered(false), m_stamp(do_make_stamp()), m_coll_opt(nullptr), m_park_opt(nullptr), m_cand_opt(nullptr),
+        m_list_opt(nullptr), m_list_prev(nullptr), m_list_next(nullptr)
       {
       }
     ~Variable();
@@ -35,7 +54,11 @@ class Variable : public rocket::refcounted_base<Variable>
       = delete;
 
   private:
+    static Uint64 do_make_stamp() noexcept;
     [[noreturn]] void do_throw_immutable() const;
+    void do_write_barrier();
+    void do_unpark();
+    void do_buffer() noexcept;
 
   public:
     const Value & get_value() const noexcept
@@ -56,13 +79,59 @@ class Variable : public rocket::refcounted_base<Variable>
         if(this->m_immutable) {
           this->do_throw_immutable();
         }
+        this->bump_stamp();
         this->m_value = std::forward<XvalueT>(value);
+        this->notify_modified();
       }
     template<typename XvalueT, typename std::enable_if<std::is_constructible<Value, XvalueT &&>::value>::type * = nullptr>
       void reset(XvalueT &&value, bool immutable)
       {
+        this->bump_stamp();
         this->m_value = std::forward<XvalueT>(value);
         this->m_immutable = immutable;
+        this->notify_modified();
+      }
+
+    // The stamp is changed whenever the value is modified, or copied in a way that shares storage with it, so pointers
+    // into the value that were obtained along with a stamp remain valid as long as the stamp is unchanged.
+    // Stamps are never reused, even by another variable, so a stamp also identifies the variable that it came from.
+    // N.B. The stamp shall be bumped before the value is modified, as this also serves as the write barrier for
+    // incremental garbage collection.
+    Uint64 get_stamp() const noexcept
+      {
+        return this->m_stamp;
+      }
+    void bump_stamp()
+      {
+        this->m_stamp = do_make_stamp();
+        if(this->m_coll_opt) {
+          this->do_write_barrier();
+        }
+      }
+    // If this variable has been untracked, it is tracked again when its value may become able to form a cycle. This
+    // function shall be called after the value is modified in place.
+    void notify_modified()
+      {
+        if(this->m_park_opt && this->m_value.may_contain_variables()) {
+          this->do_unpark();
+        }
+      }
+    // This function shall be called after `bump_stamp()` if a pointer into the value is handed out, through which
+    // variables may be stored into the value at any time later.
+    void prepare_modification()
+      {
+        if(this->m_park_opt) {
+          this->do_unpark();
+        }
+      }
+
+    // This function shall be called before a reference to this variable is dropped, which may leave a cycle
+    // unreachable. See `Collector::buffer_candidate()`.
+    void notify_released() noexcept
+      {
+        if(this->m_cand_opt && !this->m_buffered) {
+          this->do_buffer();
+        }
       }
 
     long get_gcref() const noexcept
@@ -73,8 +142,51 @@ class Variable : public rocket::refcounted_base<Variable>
       {
         this->m_gcref = gcref;
       }
+    Collector * get_collector_opt() const noexcept
+      {
+        return this->m_coll_opt;
+      }
+    void set_collector_opt(Collector *coll_opt) noexcept
+      {
+        this->m_coll_opt = coll_opt;
+      }
+    Collector * get_park_collector_opt() const noexcept
+      {
+        return this->m_park_opt;
+      }
+    void set_park_collector_opt(Collector *park_opt) noexcept
+      {
+        this->m_park_opt = park_opt;
+      }
+    Collector * get_candidate_collector_opt() const noexcept
+      {
+        return this->m_cand_opt;
+      }
+    void set_candidate_collector_opt(Collector *cand_opt) noexcept
+      {
+        this->m_cand_opt = cand_opt;
+      }
+    bool is_buffered() const noexcept
+      {
+        return this->m_buffered;
+      }
+    void set_buffered(bool buffered) noexcept
+      {
+        this->m_buffered = buffered;
+      }
+    // This function returns the list that contains this variable, which may be a weak one.
+    Variable_list * get_list_opt() const noexcept
+      {
+        return this->m_list_opt;
+      }
 
     void enumerate_variables(const Abstract_variable_callback &callback) const;
+    // See `Value::enumerate_variables_with()`.
+    template<typename FunctionT>
+      void enumerate_variables_with(FunctionT &&func) const
+      {
+        this->m_value.enumerate_variables_with(func);
+      }
   };
 
 }
@@ -0,0 +1,109 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "variable_list.hpp"
+
+namespace Asteria {
+
+Variable_list::~Variable_list()
+  {
+    this->clear();
+  }
+
+void Variable_list::do_link(Variable *var) noexcept
+  {
+    ROCKET_ASSERT(!var->m_list_opt);
+    var->m_list_opt = this;
+    var->m_list_prev = this->m_tail;
+    var->m_list_next = nullptr;
+    if(this->m_tail) {
+      this->m_tail->m_list_next = var;
+    } else {
+      this->m_head = var;
+    }
+    this->m_tail = var;
+    this->m_size += 1;
+  }
+
+Variable * Variable_list::do_unlink(Variable *var) noexcept
+  {
+    ROCKET_ASSERT(var->m_list_opt == this);
+    const auto prev = var->m_list_prev;
+    const auto next = var->m_list_next;
+    if(prev) {
+      prev->m_list_next = next;
+    } else {
+      this->m_head = next;
+    }
+    if(next) {
+      next->m_list_prev = prev;
+    } else {
+      this->m_tail = prev;
+    }
+    this->m_size -= 1;
+    var->m_list_opt = nullptr;
+    var->m_list_prev = nullptr;
+    var->m_list_next = nullptr;
+    return var;
+  }
+
+void Variable_list::clear() noexcept
+  {
+    // Detach all variables first, as destroying one may cause others to be erased.
+    auto var = this->m_head;
+    this->m_head = nullptr;
+    this->m_tail = nullptr;
+    this->m_size = 0;
+    while(var) {
+      const auto next = var->m_list_next;
+      var->m_list_opt = nullptr;
+      var->m_list_prev = nullptr;
+      var->m_list_next = nullptr;
+      if(!this->m_weak) {
+        // Drop the reference held by this list.
+        const rocket::refcounted_ptr<Variable> ref(var);
+      }
+      var = next;
+    }
+  }
+
+bool Variable_list::insert(const rocket::refcounted_ptr<Variable> &var) noexcept
+  {
+    if(var->m_list_opt) {
+      return false;
+    }
+    if(this->m_weak) {
+      this->do_link(var.get());
+      return true;
+    }
+    // Take a reference, which is released when the variable is erased.
+    this->do_link(rocket::refcounted_ptr<Variable>(var).release());
+    return true;
+  }
+
+bool Variable_list::erase(Variable &var) noexcept
+  {
+    if(var.m_list_opt != this) {
+      return false;
+    }
+    if(this->m_weak) {
+      this->do_unlink(&var);
+      return true;
+    }
+    // Drop the reference held by this list.
+    const rocket::refcounted_ptr<Variable> ref(this->do_unlink(&var));
+    return true;
+  }
+
+bool Variable_list::transfer(Variable_list &other, Variable &var) noexcept
+  {
+    if(var.m_list_opt != this) {
+      return false;
+    }
+    ROCKET_ASSERT(this->m_weak == other.m_weak);
+    other.do_link(this->do_unlink(&var));
+    return true;
+  }
+
+}
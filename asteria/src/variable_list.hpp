@@ -0,0 +1,92 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_VARIABLE_LIST_HPP_
+#define ASTERIA_VARIABLE_LIST_HPP_
+
+#include "fwd.hpp"
+#include "variable.hpp"
+#include "rocket/refcounted_ptr.hpp"
+
+namespace Asteria {
+
+// This is an intrusive doubly linked list, whose links are stored in variables, so a variable can be in at most one list
+// at a time. Unless the list is weak, it holds a reference to each variable in it. A variable removes itself from the
+// weak list that it is in when it is destroyed.
+class Variable_list
+  {
+  private:
+    Variable *m_head;
+    Variable *m_tail;
+    Size m_size;
+    bool m_weak;
+
+  public:
+    explicit Variable_list(bool weak = false) noexcept
+      : m_head(nullptr), m_tail(nullptr), m_size(0), m_weak(weak)
+      {
+      }
+    ~Variable_list();
+
+    Variable_list(const Variable_list &)
+      = delete;
+    Variable_list & operator=(const Variable_list &)
+      = delete;
+
+  private:
+    void do_link(Variable *var) noexcept;
+    Variable * do_unlink(Variable *var) noexcept;
+
+  public:
+    bool is_weak() const noexcept
+      {
+        return this->m_weak;
+      }
+    bool empty() const noexcept
+      {
+        return this->m_size == 0;
+      }
+    Size size() const noexcept
+      {
+        return this->m_size;
+      }
+    void clear() noexcept;
+
+    // These functions are used for enumeration. The variable returned by `next()` is the one following `var`, which
+    // shall be in this list.
+    Variable * first() const noexcept
+      {
+        return this->m_head;
+      }
+    Variable * next(const Variable &var) const noexcept
+      {
+        ROCKET_ASSERT(var.m_list_opt == this);
+        return var.m_list_next;
+      }
+    template<typename FuncT>
+      void for_each(FuncT &&func) const
+      {
+        auto var = this->m_head;
+        while(var) {
+          const auto next = var->m_list_next;
+          std::forward<FuncT>(func)(*var);
+          var = next;
+        }
+      }
+
+    bool has(const Variable &var) const noexcept
+      {
+        return var.m_list_opt == this;
+      }
+    // If `var` is in another list, this function fails.
+    bool insert(const rocket::refcounted_ptr<Variable> &var) noexcept;
+    // The caller shall hold a reference to `var` if it may be destroyed when this function returns.
+    bool erase(Variable &var) noexcept;
+    // This function moves `var` from this list to the end of `other` without changing its reference count.
+    // Both lists shall be either weak or not.
+    bool transfer(Variable_list &other, Variable &var) noexcept;
+  };
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#include "precompiled.hpp"
+#include "variable_pool.hpp"
+#include "variable.hpp"
+#include "utilities.hpp"
+
+namespace Asteria {
+
+  namespace {
+
+  union Slot
+    {
+      Slot *next;
+      std::aligned_storage<sizeof(Variable), alignof(Variable)>::type storage;
+    };
+
+  // This is the number of variables in a slab.
+  constexpr Size slab_size = 64;
+
+  }
+
+Variable_pool::~Variable_pool()
+  {
+    // All variables have been destroyed, as each of them holds a reference to this pool.
+    ROCKET_ASSERT(this->m_free_count == this->get_capacity());
+    for(const auto slab : this->m_slabs) {
+      ::operator delete(slab);
+    }
+  }
+
+void * Variable_pool::do_allocate()
+  {
+    auto slot = static_cast<Slot *>(this->m_free_head);
+    if(!slot) {
+      ASTERIA_DEBUG_LOG("Allocating a new slab: this = ", static_cast<void *>(this), ", slabs = ", this->m_slabs.size());
+      this->m_slabs.reserve(this->m_slabs.size() + 1);
+      const auto slab = static_cast<Slot *>(::operator new(sizeof(Slot) * slab_size));
+      this->m_slabs.emplace_back(slab);
+      // Link slots in ascending order of addresses, so variables that are created one after another are adjacent.
+      for(Size i = 0; i < slab_size - 1; ++i) {
+        slab[i].next = slab + i + 1;
+      }
+      slab[slab_size - 1].next = nullptr;
+      this->m_free_count += slab_size;
+      slot = slab;
+    }
+    this->m_free_head = slot->next;
+    this->m_free_count -= 1;
+    return slot;
+  }
+
+Size Variable_pool::get_capacity() const noexcept
+  {
+    return this->m_slabs.size() * slab_size;
+  }
+
+rocket::refcounted_ptr<Variable> Variable_pool::create_variable()
+  {
+    const auto ptr = this->do_allocate();
+    Variable *var;
+    try {
+      var = ::new(ptr) Variable();
+    } catch(...) {
+      this->deallocate(ptr);
+      throw;
+    }
+    var->as_deleter().set_pool(this->share_this<Variable_pool>());
+    return rocket::refcounted_ptr<Variable>(var);
+  }
+
+void Variable_pool::deallocate(void *ptr) noexcept
+  {
+    const auto slot = static_cast<Slot *>(ptr);
+    slot->next = static_cast<Slot *>(this->m_free_head);
+    this->m_free_head = slot;
+    this->m_free_count += 1;
+  }
+
+void Variable_deleter::operator()(Variable *var) const noexcept
+  {
+    const auto pool = this->m_pool_opt.get();
+    if(!pool) {
+      delete var;
+      return;
+    }
+    var->~Variable();
+    pool->deallocate(var);
+  }
+
+}
@@ -0,0 +1,87 @@
+// This file is part of Asteria.
+// Copyleft 2018, LH_Mouse. All wrongs reserved.
+
+#ifndef ASTERIA_VARIABLE_POOL_HPP_
+#define ASTERIA_VARIABLE_POOL_HPP_
+
+#include "fwd.hpp"
+#include "rocket/refcounted_ptr.hpp"
+
+namespace Asteria {
+
+// Variables are allocated from slabs, each of which holds a fixed number of them, so variables that are created one
+// after another are laid out next to each other. Freed storage is kept in a singly linked list and is reused in LIFO
+// order, so storage that is likely in cache is handed out first. As all variables have the same size, there is only
+// one size class. A variable holds a reference to the pool that it has been allocated from, so the pool outlives it.
+class Variable_pool : public rocket::refcounted_base<Variable_pool>
+  {
+  private:
+    Vector<void *> m_slabs;
+    void *m_free_head;
+    Size m_free_count;
+
+  public:
+    Variable_pool() noexcept
+      : m_slabs(), m_free_head(nullptr), m_free_count(0)
+      {
+      }
+    ~Variable_pool();
+
+    Variable_pool(const Variable_pool &)
+      = delete;
+    Variable_pool & operator=(const Variable_pool &)
+      = delete;
+
+  private:
+    void * do_allocate();
+
+  public:
+    // This function returns the number of variables that can be created without allocating a new slab.
+    Size get_free_count() const noexcept
+      {
+        return this->m_free_count;
+      }
+    // This function returns the number of variables that all slabs can hold, including those in use.
+    Size get_capacity() const noexcept;
+
+    rocket::refcounted_ptr<Variable> create_variable();
+    // This function is called by `Variable_deleter` after a variable has been destroyed.
+    void deallocate(void *ptr) noexcept;
+  };
+
+// This is the deleter of all variables. If a variable has been allocated from a pool, its storage is returned to the
+// pool. Otherwise, it is deleted using `delete`.
+class Variable_deleter
+  {
+  private:
+    rocket::refcounted_ptr<Variable_pool> m_pool_opt;
+
+  public:
+    Variable_deleter() noexcept
+      : m_pool_opt()
+      {
+      }
+    // As this is a virtual base of `Variable`, it shall not be assigned.
+    Variable_deleter(const Variable_deleter &) noexcept
+      = default;
+    Variable_deleter(Variable_deleter &&) noexcept
+      = default;
+    Variable_deleter & operator=(const Variable_deleter &)
+      = delete;
+
+  public:
+    const Variable_pool * get_pool_opt() const noexcept
+      {
+        return this->m_pool_opt.get();
+      }
+    void set_pool(rocket::refcounted_ptr<Variable_pool> pool_opt) noexcept
+      {
+        this->m_pool_opt = std::move(pool_opt);
+      }
+
+    void operator()(Variable *var) const noexcept;
+  };
+
+}
+
+#endif
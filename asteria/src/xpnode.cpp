@@ -24,6 +24,9 @@ const char * Xpnode::get_operator_name(Xpnode::Xop xop) noexcept
       case xop_postfix_dec: {
         return "postfix decrement";
       }
+      case xop_postfix_slice: {
+        return "slice";
+      }
       case xop_prefix_pos: {
         return "unary plus";
       }
@@ -201,8 +204,8 @@ Xpnode Xpnode::bind(const Global_context &global, const Analytic_context &ctx) c
       }
       case index_subscript: {
         const auto &alt = this->m_stor.as<S_subscript>();
-        // Copy it as-is.
-        Xpnode::S_subscript alt_bnd = { alt.name };
+        // Copy it, except for the cache, which belongs to the bound node.
+        Xpnode::S_subscript alt_bnd = { alt.name, alt.hash, rocket::make_refcounted<Reference::S_site_cache>() };
         return std::move(alt_bnd);
       }
       case index_operator_rpn: {
@@ -289,47 +292,6 @@ Xpnode Xpnode::bind(const Global_context &global, const Analytic_context &ctx) c
       return static_cast<D_integer>(reg);
     }
 
-  D_integer do_add(D_integer lhs, D_integer rhs)
-    {
-      using Limits = std::numeric_limits<D_integer>;
-      if((rhs >= 0) ? (lhs > Limits::max() - rhs) : (lhs < Limits::min() - rhs)) {
-        ASTERIA_THROW_RUNTIME_ERROR("Integral addition of `", lhs, "` and `", rhs, "` would result in overflow.");
-      }
-      return lhs + rhs;
-    }
-
-  D_integer do_subtract(D_integer lhs, D_integer rhs)
-    {
-      using Limits = std::numeric_limits<D_integer>;
-      if((rhs >= 0) ? (lhs < Limits::min() + rhs) : (lhs > Limits::max() + rhs)) {
-        ASTERIA_THROW_RUNTIME_ERROR("Integral subtraction of `", lhs, "` and `", rhs, "` would result in overflow.");
-      }
-      return lhs - rhs;
-    }
-
-  D_integer do_multiply(D_integer lhs, D_integer rhs)
-    {
-      using Limits = std::numeric_limits<D_integer>;
-      if((lhs == 0) || (rhs == 0)) {
-        return 0;
-      }
-      if((lhs == 1) || (rhs == 1)) {
-        return lhs ^ rhs ^ 1;
-      }
-      if((lhs == Limits::min()) || (rhs == Limits::min())) {
-        ASTERIA_THROW_RUNTIME_ERROR("Integral multiplication of `", lhs, "` and `", rhs, "` would result in overflow.");
-      }
-      if((lhs == -1) || (rhs == -1)) {
-        return -(lhs ^ rhs ^ -1);
-      }
-      const auto slhs = (rhs >= 0) ? lhs : -lhs;
-      const auto arhs = std::abs(rhs);
-      if((slhs >= 0) ? (slhs > Limits::max() / arhs) : (slhs < Limits::min() / arhs)) {
-        ASTERIA_THROW_RUNTIME_ERROR("Integral multiplication of `", lhs, "` and `", rhs, "` would result in overflow.");
-      }
-      return slhs * arhs;
-    }
-
   D_integer do_divide(D_integer lhs, D_integer rhs)
     {
       using Limits = std::numeric_limits<D_integer>;
@@ -471,9 +433,8 @@ Xpnode Xpnode::bind(const Global_context &global, const Analytic_context &ctx) c
 
   D_string do_concatenate(const D_string &lhs, const D_string &rhs)
     {
-      D_string res;
-      res.reserve(lhs.size() + rhs.size());
-      res.append(lhs);
+      // The result is a rope. If `lhs` is a rope too, the characters of `rhs` are appended to its buffer in place.
+      auto res = lhs;
       res.append(rhs);
       return res;
     }
@@ -483,17 +444,18 @@ Xpnode Xpnode::bind(const Global_context &global, const Analytic_context &ctx) c
       if(rhs < 0) {
         ASTERIA_THROW_RUNTIME_ERROR("String duplication count `", rhs, "` for `", lhs, "` is negative.");
       }
-      D_string res;
+      String res;
+      const auto &str = lhs.flatten();
       const auto count = static_cast<Uint64>(rhs);
       if(count != 0) {
-        if(lhs.size() > res.max_size() / count) {
+        if(str.size() > res.max_size() / count) {
           ASTERIA_THROW_RUNTIME_ERROR("Duplication of `", lhs, "` up to `", rhs, "` times would result in an overlong string that cannot be allocated.");
         }
-        res.reserve(lhs.size() * static_cast<Size>(count));
+        res.reserve(str.size() * static_cast<Size>(count));
         auto mask = std::numeric_limits<Size>::max() / 2 + 1;
         do {
           if(count & mask) {
-            res.append(lhs);
+            res.append(str);
           }
           if((mask >>= 1) == 0) {
             break;
@@ -504,6 +466,103 @@ Xpnode Xpnode::bind(const Global_context &global, const Analytic_context &ctx) c
       return res;
     }
 
+  void do_duplicate_in_place(D_string &lhs_io, D_integer rhs)
+    {
+      if(rhs < 0) {
+        ASTERIA_THROW_RUNTIME_ERROR("String duplication count `", rhs, "` for `", lhs_io, "` is negative.");
+      }
+      const auto count = static_cast<Uint64>(rhs);
+      if((count != 0) && (lhs_io.size() > String().max_size() / count)) {
+        ASTERIA_THROW_RUNTIME_ERROR("Duplication of `", lhs_io, "` up to `", rhs, "` times would result in an overlong string that cannot be allocated.");
+      }
+      lhs_io.repeat(static_cast<Size>(count));
+    }
+
+  // If the target of a compound assignment can be opened and the operation does not change its type, it is performed
+  // in place, so the path to the target is walked only once and unshared strings are extended rather than copied.
+  // This function returns `false` if the caller shall fall back to `peek()` and `write()`.
+  bool do_evaluate_in_place(const Reference &lhs, Xpnode::Xop xop, const Reference &rhs)
+    {
+      const auto qlhs = lhs.open_opt();
+      if(!qlhs) {
+        return false;
+      }
+      // N.B. Opening the target invalidates results of `peek()` on `rhs` if both operands refer to the same variable,
+      // so `rhs` is peeked afterwards.
+      Value rhs_temp;
+      const auto &rhs_value = rhs.peek(rhs_temp);
+      const auto ltype = qlhs->type();
+      const auto rtype = rhs_value.type();
+      switch(rocket::weaken_enum(xop)) {
+        case Xpnode::xop_infix_add: {
+          if((ltype == Value::type_integer) && (rtype == Value::type_integer)) {
+            qlhs->check<D_integer>() = checked_add(qlhs->check<D_integer>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          if((ltype == Value::type_real) && (rtype == Value::type_real)) {
+            qlhs->check<D_real>() = do_add(qlhs->check<D_real>(), rhs_value.check<D_real>());
+            return true;
+          }
+          if((ltype == Value::type_string) && (rtype == Value::type_string)) {
+            qlhs->check<D_string>().append(rhs_value.check<D_string>());
+            return true;
+          }
+          return false;
+        }
+        case Xpnode::xop_infix_sub: {
+          if((ltype == Value::type_integer) && (rtype == Value::type_integer)) {
+            qlhs->check<D_integer>() = checked_subtract(qlhs->check<D_integer>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          if((ltype == Value::type_real) && (rtype == Value::type_real)) {
+            qlhs->check<D_real>() = do_subtract(qlhs->check<D_real>(), rhs_value.check<D_real>());
+            return true;
+          }
+          return false;
+        }
+        case Xpnode::xop_infix_mul: {
+          if((ltype == Value::type_integer) && (rtype == Value::type_integer)) {
+            qlhs->check<D_integer>() = checked_multiply(qlhs->check<D_integer>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          if((ltype == Value::type_real) && (rtype == Value::type_real)) {
+            qlhs->check<D_real>() = do_multiply(qlhs->check<D_real>(), rhs_value.check<D_real>());
+            return true;
+          }
+          if((ltype == Value::type_string) && (rtype == Value::type_integer)) {
+            do_duplicate_in_place(qlhs->check<D_string>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          return false;
+        }
+        case Xpnode::xop_infix_div: {
+          if((ltype == Value::type_integer) && (rtype == Value::type_integer)) {
+            qlhs->check<D_integer>() = do_divide(qlhs->check<D_integer>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          if((ltype == Value::type_real) && (rtype == Value::type_real)) {
+            qlhs->check<D_real>() = do_divide(qlhs->check<D_real>(), rhs_value.check<D_real>());
+            return true;
+          }
+          return false;
+        }
+        case Xpnode::xop_infix_mod: {
+          if((ltype == Value::type_integer) && (rtype == Value::type_integer)) {
+            qlhs->check<D_integer>() = do_modulo(qlhs->check<D_integer>(), rhs_value.check<D_integer>());
+            return true;
+          }
+          if((ltype == Value::type_real) && (rtype == Value::type_real)) {
+            qlhs->check<D_real>() = do_modulo(qlhs->check<D_real>(), rhs_value.check<D_real>());
+            return true;
+          }
+          return false;
+        }
+        default: {
+          ASTERIA_TERMINATE("The ", Xpnode::get_operator_name(xop), " operation cannot be evaluated in place.");
+        }
+      }
+    }
+
   }
 
 void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const Executive_context &ctx) const
@@ -511,8 +570,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
     switch(Index(this->m_stor.index())) {
       case index_literal: {
         const auto &alt = this->m_stor.as<S_literal>();
-        // Push the constant.
-        Reference_root::S_constant ref_c = { alt.value };
+        // Push a reference to the constant, which lives as long as this node.
+        Reference_root::S_constant_ref ref_c = { &(alt.value) };
         stack_io.push(std::move(ref_c));
         return;
       }
@@ -547,7 +606,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
         auto cond = do_pop_reference(stack_io);
         // Read the condition and pick a branch.
         const auto stack_size_old = stack_io.size();
-        const auto has_result = (cond.read().test() ? alt.branch_true : alt.branch_false).evaluate_partial(stack_io, global, ctx);
+        Value cond_temp;
+        const auto has_result = (cond.peek(cond_temp).test() ? alt.branch_true : alt.branch_false).evaluate_partial(stack_io, global, ctx);
         if(has_result) {
           ROCKET_ASSERT(stack_io.size() == stack_size_old + 1);
           // The result will have been pushed onto `stack_io`.
@@ -576,6 +636,7 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
         }
         // Pop the target off the stack.
         auto tgt = do_pop_reference(stack_io);
+        // N.B. The target is copied, as the function may modify the variable holding it during the call.
         const auto tgt_value = tgt.read();
         // Make sure it is really a function.
         const auto qfunc = tgt_value.opt<D_function>();
@@ -605,15 +666,21 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
       }
       case index_subscript: {
         const auto &alt = this->m_stor.as<S_subscript>();
-        // Get the subscript.
-        Value sub_value;
         if(!alt.name.empty()) {
-          sub_value = D_string(alt.name);
-        } else {
-          auto sub = do_pop_reference(stack_io);
-          sub_value = sub.read();
+          // The name is a constant, whose hash value is known.
+          auto cursor = do_pop_reference(stack_io);
+          Reference_modifier::S_object_key mod_c(alt.name, alt.hash);
+          cursor.zoom_in(std::move(mod_c));
+          cursor.share_site_cache(alt.cache);
+          stack_io.push(std::move(cursor));
+          return;
         }
+        // Get the subscript.
+        auto sub = do_pop_reference(stack_io);
+        Value sub_temp;
+        const auto &sub_value = sub.peek(sub_temp);
         auto cursor = do_pop_reference(stack_io);
+        sub.check_peeked();
         // The subscript operand shall have type `integer` or `string`.
         switch(rocket::weaken_enum(sub_value.type())) {
           case Value::type_integer: {
@@ -622,7 +689,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             break;
           }
           case Value::type_string: {
-            Reference_modifier::S_object_key mod_c = { sub_value.check<D_string>() };
+            const auto &key = sub_value.check<D_string>().flatten();
+            Reference_modifier::S_object_key mod_c(key);
             cursor.zoom_in(std::move(mod_c));
             break;
           }
@@ -630,6 +698,7 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             ASTERIA_THROW_RUNTIME_ERROR("The value `", sub_value, "` cannot be used as a subscript.");
           }
         }
+        cursor.share_site_cache(alt.cache);
         stack_io.push(std::move(cursor));
         return;
       }
@@ -640,10 +709,11 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Increment the operand and return the old value.
             // `assign` is ignored.
             auto lhs = do_pop_reference(stack_io);
-            auto lhs_value = lhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
             if(lhs_value.type() == Value::type_integer) {
               auto result = lhs_value.check<D_integer>();
-              do_set_result(lhs, true, do_add(result, D_integer(1)));
+              do_set_result(lhs, true, checked_add(result, 1));
               do_set_result(lhs, false, std::move(result));
               stack_io.push(std::move(lhs));
               break;
@@ -661,10 +731,11 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Decrement the operand and return the old value.
             // `assign` is ignored.
             auto lhs = do_pop_reference(stack_io);
-            auto lhs_value = lhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
             if(lhs_value.type() == Value::type_integer) {
               auto result = lhs_value.check<D_integer>();
-              do_set_result(lhs, true, do_subtract(result, D_integer(1)));
+              do_set_result(lhs, true, checked_subtract(result, 1));
               do_set_result(lhs, false, std::move(result));
               stack_io.push(std::move(lhs));
               break;
@@ -678,6 +749,61 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             }
             ASTERIA_THROW_RUNTIME_ERROR("The ", get_operator_name(alt.xop), " operation is not defined for `", lhs_value, "`.");
           }
+          case xop_postfix_slice: {
+            // Return `count` elements of the operand starting from `pos`, or all elements from `pos` if `count` is null.
+            // The result shares storage with the operand.
+            // `assign` is ignored.
+            auto count = do_pop_reference(stack_io);
+            auto pos = do_pop_reference(stack_io);
+            auto lhs = do_pop_reference(stack_io);
+            Value count_temp;
+            const auto &count_value = count.peek(count_temp);
+            Value pos_temp;
+            const auto &pos_value = pos.peek(pos_temp);
+            // N.B. The result shares storage with the operand, so the operand is copied with `read()`, which prevents
+            // the operand from being modified in place via pointers cached before.
+            const auto lhs_value = lhs.read();
+            if(pos_value.type() != Value::type_integer) {
+              ASTERIA_THROW_RUNTIME_ERROR("The slice position `", pos_value, "` is not an integer.");
+            }
+            Size rcount = Size(-1);
+            if(count_value.type() != Value::type_null) {
+              if((count_value.type() != Value::type_integer) || (count_value.check<D_integer>() < 0)) {
+                ASTERIA_THROW_RUNTIME_ERROR("The slice length `", count_value, "` is not a non-negative integer.");
+              }
+              rcount = static_cast<Size>(rocket::min(static_cast<Uint64>(count_value.check<D_integer>()), Uint64(SIZE_MAX)));
+            }
+            // A negative position is counted from the end, as for subscripts.
+            Size size;
+            switch(rocket::weaken_enum(lhs_value.type())) {
+              case Value::type_string: {
+                size = lhs_value.check<D_string>().size();
+                break;
+              }
+              case Value::type_array: {
+                size = lhs_value.check<D_array>().size();
+                break;
+              }
+              default: {
+                ASTERIA_THROW_RUNTIME_ERROR("The ", get_operator_name(alt.xop), " operation is not defined for `", lhs_value, "`.");
+              }
+            }
+            Uint64 bfill, efill;
+            const auto rpos = wrap_index(bfill, efill, pos_value.check<D_integer>(), size);
+            if((bfill != 0) || (rpos > size)) {
+              ASTERIA_THROW_RUNTIME_ERROR("The slice position `", pos_value, "` is out of range for `", lhs_value, "`.");
+            }
+            if(lhs_value.type() == Value::type_string) {
+              auto result = lhs_value.check<D_string>().substr(static_cast<Size>(rpos), rcount);
+              do_set_result(lhs, false, std::move(result));
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            auto result = lhs_value.check<D_array>().subarray(static_cast<Size>(rpos), rcount);
+            do_set_result(lhs, false, std::move(result));
+            stack_io.push(std::move(lhs));
+            break;
+          }
           case xop_prefix_pos: {
             auto rhs = do_pop_reference(stack_io);
             // Copy the operand to create an rvalue, then return it.
@@ -690,7 +816,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
           case xop_prefix_neg: {
             auto rhs = do_pop_reference(stack_io);
             // Negate the operand to create an rvalue, then return it.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if(rhs_value.type() == Value::type_integer) {
               auto result = do_negate(rhs_value.check<D_integer>(), rhs.is_constant());
               do_set_result(rhs, alt.assign, std::move(result));
@@ -708,7 +835,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
           case xop_prefix_notb: {
             auto rhs = do_pop_reference(stack_io);
             // Perform bitwise not operation on the operand to create an rvalue, then return it.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if(rhs_value.type() == Value::type_boolean) {
               auto result = do_logical_not(rhs_value.check<D_boolean>());
               do_set_result(rhs, alt.assign, std::move(result));
@@ -727,7 +855,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             // Perform logical NOT operation on the operand to create an rvalue, then return it.
             // N.B. This is one of the few operators that work on all types.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto result = !rhs_value.test();
             do_set_result(rhs, alt.assign, std::move(result));
             stack_io.push(std::move(rhs));
@@ -737,9 +866,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             // Increment the operand and return it.
             // `assign` is ignored.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if(rhs_value.type() == Value::type_integer) {
-              auto result = do_add(rhs_value.check<D_integer>(), D_integer(1));
+              auto result = checked_add(rhs_value.check<D_integer>(), 1);
               do_set_result(rhs, true, std::move(result));
               stack_io.push(std::move(rhs));
               break;
@@ -756,9 +886,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             // Decrement the operand and return it.
             // `assign` is ignored.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if(rhs_value.type() == Value::type_integer) {
-              auto result = do_subtract(rhs_value.check<D_integer>(), D_integer(1));
+              auto result = checked_subtract(rhs_value.check<D_integer>(), 1);
               do_set_result(rhs, true, std::move(result));
               stack_io.push(std::move(rhs));
               break;
@@ -782,7 +913,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
           case xop_prefix_lengthof: {
             auto rhs = do_pop_reference(stack_io);
             // Return the number of elements in `rhs`.
-            auto rhs_value = rhs.read();
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if(rhs_value.type() == Value::type_null) {
               auto result = D_integer(0);
               do_set_result(rhs, alt.assign, std::move(result));
@@ -814,8 +946,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // Report unordered operands as being unequal.
             // N.B. This is one of the few operators that work on all types.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             auto result = comp == Value::compare_equal;
             do_set_result(lhs, false, result);
@@ -827,8 +961,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // Report unordered operands as being unequal.
             // N.B. This is one of the few operators that work on all types.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             auto result = comp != Value::compare_equal;
             do_set_result(lhs, false, result);
@@ -839,8 +975,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // Throw an exception in case of unordered operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             if(comp == Value::compare_unordered) {
               ASTERIA_THROW_RUNTIME_ERROR("The operands `", lhs_value, "` and `", rhs_value, "` are uncomparable.");
@@ -854,8 +992,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // Throw an exception in case of unordered operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             if(comp == Value::compare_unordered) {
               ASTERIA_THROW_RUNTIME_ERROR("The operands `", lhs_value, "` and `", rhs_value, "` are uncomparable.");
@@ -869,8 +1009,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // Throw an exception in case of unordered operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             if(comp == Value::compare_unordered) {
               ASTERIA_THROW_RUNTIME_ERROR("The operands `", lhs_value, "` and `", rhs_value, "` are uncomparable.");
@@ -884,8 +1026,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // Throw an exception in case of unordered operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             if(comp == Value::compare_unordered) {
               ASTERIA_THROW_RUNTIME_ERROR("The operands `", lhs_value, "` and `", rhs_value, "` are uncomparable.");
@@ -899,8 +1043,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // N.B. This is one of the few operators that work on all types.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             auto comp = lhs_value.compare(rhs_value);
             switch(comp) {
               case Value::compare_less: {
@@ -932,8 +1078,14 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // For the `boolean` type, return the logical OR'd result of both operands.
             // For the `integer` and `real` types, return the sum of both operands.
             // For the `string` type, concatenate the operands in lexical order to create a new string, then return it.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            if(alt.assign && do_evaluate_in_place(lhs, alt.xop, rhs)) {
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_or(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -941,7 +1093,7 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
               break;
             }
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
-              auto result = do_add(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
+              auto result = checked_add(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
               stack_io.push(std::move(lhs));
               break;
@@ -965,8 +1117,14 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // For the `boolean` type, return the logical XOR'd result of both operands.
             // For the `integer` and `real` types, return the difference of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            if(alt.assign && do_evaluate_in_place(lhs, alt.xop, rhs)) {
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_xor(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -974,7 +1132,7 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
               break;
             }
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
-              auto result = do_subtract(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
+              auto result = checked_subtract(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
               stack_io.push(std::move(lhs));
               break;
@@ -993,8 +1151,14 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // For the boolean type, return the logical AND'd result of both operands.
             // For the integer and real types, return the product of both operands.
             // If either operand has the integer type and the other has the string type, duplicate the string up to the specified number of times.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            if(alt.assign && do_evaluate_in_place(lhs, alt.xop, rhs)) {
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_and(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1002,7 +1166,7 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
               break;
             }
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
-              auto result = do_multiply(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
+              auto result = checked_multiply(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
               stack_io.push(std::move(lhs));
               break;
@@ -1031,8 +1195,14 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // For the integer and real types, return the quotient of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            if(alt.assign && do_evaluate_in_place(lhs, alt.xop, rhs)) {
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_divide(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1051,8 +1221,14 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto rhs = do_pop_reference(stack_io);
             auto lhs = do_pop_reference(stack_io);
             // For the integer and real types, return the reminder of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            if(alt.assign && do_evaluate_in_place(lhs, alt.xop, rhs)) {
+              stack_io.push(std::move(lhs));
+              break;
+            }
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_modulo(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1073,8 +1249,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Shift the first operand to the left by the number of bits specified by the second operand
             // Bits shifted out are discarded. Bits shifted in are filled with zeroes.
             // Both operands have to be integers.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_shift_left_logical(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1089,8 +1267,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Shift the first operand to the right by the number of bits specified by the second operand
             // Bits shifted out are discarded. Bits shifted in are filled with zeroes.
             // Both operands have to be integers.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_shift_right_logical(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1106,8 +1286,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Bits shifted out that equal the sign bit are dicarded. Bits shifted in are filled with zeroes.
             // If a bit unequal to the sign bit would be shifted into or across the sign bit, an exception is thrown.
             // Both operands have to be integers.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_shift_left_arithmetic(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1122,8 +1304,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             // Shift the first operand to the right by the number of bits specified by the second operand
             // Bits shifted out are discarded. Bits shifted in are filled with the sign bit.
             // Both operands have to be integers.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_integer) && (rhs_value.type() == Value::type_integer)) {
               auto result = do_shift_right_arithmetic(lhs_value.check<D_integer>(), rhs_value.check<D_integer>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1137,8 +1321,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // For the `boolean` type, return the logical AND'd result of both operands.
             // For the `integer` type, return the bitwise AND'd result of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_and(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1158,8 +1344,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // For the `boolean` type, return the logical OR'd result of both operands.
             // For the `integer` type, return the bitwise OR'd result of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_or(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1179,8 +1367,10 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
             auto lhs = do_pop_reference(stack_io);
             // For the `boolean` type, return the logical XOR'd result of both operands.
             // For the `integer` type, return the bitwise XOR'd result of both operands.
-            auto lhs_value = lhs.read();
-            auto rhs_value = rhs.read();
+            Value lhs_temp;
+            const auto &lhs_value = lhs.peek(lhs_temp);
+            Value rhs_temp;
+            const auto &rhs_value = rhs.peek(rhs_temp);
             if((lhs_value.type() == Value::type_boolean) && (rhs_value.type() == Value::type_boolean)) {
               auto result = do_logical_xor(lhs_value.check<D_boolean>(), rhs_value.check<D_boolean>());
               do_set_result(lhs, alt.assign, std::move(result));
@@ -1215,11 +1405,17 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
       case index_unnamed_array: {
         const auto &alt = this->m_stor.as<S_unnamed_array>();
         // Pop references to create an array.
-        D_array array;
-        array.resize(alt.elem_cnt);
+        Vector<Value> elems;
+        elems.resize(alt.elem_cnt);
         for(auto i = alt.elem_cnt - 1; i + 1 != 0; --i) {
           auto ref = do_pop_reference(stack_io);
-          array.mut(i) = ref.read();
+          elems.mut(i) = ref.read();
+        }
+        // Push elements in order, so arrays of numbers are stored unboxed.
+        D_array array;
+        array.reserve(alt.elem_cnt);
+        for(auto it = elems.mut_begin(); it != elems.mut_end(); ++it) {
+          array.push_back(std::move(*it));
         }
         Reference_root::S_temporary ref_c = { std::move(array) };
         stack_io.push(std::move(ref_c));
@@ -1229,7 +1425,6 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
         const auto &alt = this->m_stor.as<S_unnamed_object>();
         // Pop references to create an object.
         D_object object;
-        object.reserve(alt.keys.size());
         for(auto it = alt.keys.rbegin(); it != alt.keys.rend(); ++it) {
           auto ref = do_pop_reference(stack_io);
           object.insert_or_assign(*it, ref.read());
@@ -1243,7 +1438,8 @@ void Xpnode::evaluate(Reference_stack &stack_io, Global_context &global, const E
         // Pop the condition off the stack.
         auto cond = do_pop_reference(stack_io);
         // Read the condition. If it is null, evaluate the branch.
-        if(cond.read().type() == Value::type_null) {
+        Value cond_temp;
+        if(cond.peek(cond_temp).type() == Value::type_null) {
           const auto stack_size_old = stack_io.size();
           const auto has_result = alt.branch_null.evaluate_partial(stack_io, global, ctx);
           if(has_result) {
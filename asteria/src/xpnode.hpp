@@ -23,6 +23,7 @@ class Xpnode
         // Postfix operators
         xop_postfix_inc      = 10,  // ++
         xop_postfix_dec      = 11,  // --
+        xop_postfix_slice    = 12,  // [ : ]
         // Prefix operators
         xop_prefix_pos       = 30,  // +
         xop_prefix_neg       = 31,  // -
@@ -87,6 +88,12 @@ class Xpnode
     struct S_subscript
       {
         String name;  // If this is empty then the subscript is to be popped from the stack.
+        Size hash;  // This is computed from `name` once, so member access need not hash the name again.
+        // N.B. Objects are hash tries and have no shapes, so no slot is cached here. Member access with a constant name
+        // still walks the trie, but only compares hash values and keys.
+        // This holds the parent resolved by the last write through a reference created here, so `a.b.c[i] = v` in a
+        // loop does not resolve `a.b.c` again and again.
+        rocket::refcounted_ptr<Reference::S_site_cache> cache;
       };
     struct S_operator_rpn
       {
@@ -46,7 +46,7 @@ int main()
     {
       nodes.emplace_back(Xpnode::S_named_reference { String::shallow("aval") });
       nodes.emplace_back(Xpnode::S_literal { D_integer(1) });
-      nodes.emplace_back(Xpnode::S_subscript { String() });
+      nodes.emplace_back(Xpnode::S_subscript { String(), 0, rocket::make_refcounted<Reference::S_site_cache>() });
       nodes.emplace_back(Xpnode::S_named_reference { String::shallow("cond") });
       nodes.emplace_back(Xpnode::S_operator_rpn { Xpnode::xop_prefix_notl, false });
       nodes.emplace_back(Xpnode::S_branch { false, std::move(branch_true), std::move(branch_false) });
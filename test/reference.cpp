@@ -4,6 +4,7 @@
 #include "_test_init.hpp"
 #include "../asteria/src/reference.hpp"
 #include "../asteria/src/global_context.hpp"
+#include "../asteria/src/collector.hpp"
 
 using namespace Asteria;
 
@@ -30,6 +31,16 @@ int main()
     ASTERIA_TEST_CHECK(val.check<D_string>() == "meow");
     ASTERIA_TEST_CHECK_CATCH(ref.write(D_boolean(true)));
 
+    Value literal(D_integer(7));
+    ref2 = Reference_root::S_constant_ref { &literal };
+    ASTERIA_TEST_CHECK(ref2.is_constant());
+    ASTERIA_TEST_CHECK(ref2.read().check<D_integer>() == 7);
+    ASTERIA_TEST_CHECK_CATCH(ref2.write(D_boolean(true)));
+    ref2.convert_to_constant();
+    literal = D_integer(8);
+    ASTERIA_TEST_CHECK(ref2.is_constant());
+    ASTERIA_TEST_CHECK(ref2.read().check<D_integer>() == 7);
+
     Global_context global;
     ref.convert_to_variable(global);
     val = ref.read();
@@ -54,7 +65,7 @@ int main()
     ref.zoom_out();
 
     ref.zoom_in(Reference_modifier::S_array_index { 2 });
-    ref.zoom_in(Reference_modifier::S_object_key { String::shallow("my_key") });
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("my_key")));
     val = ref.read();
     ASTERIA_TEST_CHECK(val.type() == Value::type_null);
     ref.write(D_real(10.5));
@@ -64,11 +75,11 @@ int main()
     ref.zoom_out();
     ref.zoom_out();
     ref.zoom_in(Reference_modifier::S_array_index { -1 });
-    ref.zoom_in(Reference_modifier::S_object_key { String::shallow("my_key") });
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("my_key")));
     val = ref.read();
     ASTERIA_TEST_CHECK(val.type() == Value::type_real);
     ASTERIA_TEST_CHECK(val.check<D_real>() == 10.5);
-    ref.zoom_in(Reference_modifier::S_object_key { String::shallow("invalid_access") });
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("invalid_access")));
     ASTERIA_TEST_CHECK_CATCH(val = ref.read());
     ref.zoom_out();
 
@@ -79,4 +90,131 @@ int main()
     ASTERIA_TEST_CHECK(val.type() == Value::type_null);
     val = ref.unset();
     ASTERIA_TEST_CHECK(val.type() == Value::type_null);
+
+    ref = Reference_root::S_temporary { D_null() };
+    ref.convert_to_variable(global);
+    for(int i = 0; i < 1000; ++i) {
+      ref.zoom_in(Reference_modifier::S_array_index { -1 - i });
+      ref.write(D_integer(i));
+      ref.zoom_out();
+    }
+    val = ref.read();
+    ASTERIA_TEST_CHECK(val.check<D_array>().size() == 1000);
+    ASTERIA_TEST_CHECK(val.check<D_array>().at(0).check<D_integer>() == 999);
+    ASTERIA_TEST_CHECK(val.check<D_array>().at(999).check<D_integer>() == 0);
+    ref.open_opt()->check<D_array>().push_back(D_string(String::shallow("meow")));
+    ref.zoom_in(Reference_modifier::S_array_index { -1 });
+    auto qval = ref.open_opt();
+    ASTERIA_TEST_CHECK(qval != nullptr);
+    qval->check<D_string>().append(D_string(String::shallow("!")));
+    val = ref.read();
+    ASTERIA_TEST_CHECK(val.check<D_string>() == "meow!");
+    Value temp;
+    ASTERIA_TEST_CHECK(&(ref.peek(temp)) == qval);
+    ref.check_peeked();
+    ref.zoom_out();
+    ref.zoom_in(Reference_modifier::S_array_index { 2000 });
+    ASTERIA_TEST_CHECK(&(ref.peek(temp)) == &temp);
+    ASTERIA_TEST_CHECK(temp.type() == Value::type_null);
+    ref = Reference_root::S_temporary { D_null() };
+    ASTERIA_TEST_CHECK(ref.open_opt() == nullptr);
+    ref.convert_to_variable(global);
+    D_array ints;
+    ints.push_back(D_integer(1));
+    ref.write(std::move(ints));
+    ref.zoom_in(Reference_modifier::S_array_index { 0 });
+    ASTERIA_TEST_CHECK(ref.open_opt() == nullptr);
+    ref.zoom_out();
+    ref.zoom_in(Reference_modifier::S_array_index { 1 });
+    ref.write(D_integer(2));
+    ref.zoom_out();
+    ASTERIA_TEST_CHECK(ref.read().check<D_array>().mode() == D_array::mode_integer);
+    ASTERIA_TEST_CHECK(ref.read().check<D_array>().at(1).check<D_integer>() == 2);
+
+    ref = Reference_root::S_temporary { D_null() };
+    ref.convert_to_variable(global);
+    auto alias = ref;
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("a")));
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("b")));
+    ref.zoom_in(Reference_modifier::S_array_index { 0 });
+    for(int i = 0; i < 10; ++i) {
+      ref.write(D_integer(i));
+    }
+    ASTERIA_TEST_CHECK(ref.peek(temp).check<D_integer>() == 9);
+    auto copy = alias.read();
+    ref.write(D_string(String::shallow("meow")));
+    ASTERIA_TEST_CHECK(ref.read().check<D_string>() == "meow");
+    val = copy.check<D_object>().at(String::shallow("a")).check<D_object>().at(String::shallow("b"));
+    ASTERIA_TEST_CHECK(val.check<D_array>().at(0).check<D_integer>() == 9);
+    alias.write(D_null());
+    ASTERIA_TEST_CHECK(ref.peek(temp).type() == Value::type_null);
+    ref.write(D_integer(42));
+    ASTERIA_TEST_CHECK(alias.read().check<D_object>().size() == 1);
+
+    ref = Reference_root::S_temporary { D_null() };
+    ref.convert_to_variable(global);
+    for(int i = 0; i < 5; ++i) {
+      ref.zoom_in(Reference_modifier::S_array_index { 1 });
+    }
+    ref.write(D_integer(5));
+    auto deep = ref;
+    deep.zoom_out();
+    deep.zoom_out();
+    ASTERIA_TEST_CHECK(deep.read().check<D_array>().at(1).check<D_array>().at(1).check<D_integer>() == 5);
+    deep.zoom_out();
+    deep.zoom_in(Reference_modifier::S_array_index { 0 });
+    ASTERIA_TEST_CHECK(deep.read().type() == Value::type_null);
+    ref.zoom_out();
+    ref.zoom_out();
+    ref.zoom_out();
+    ref.zoom_out();
+    ref.zoom_out();
+    ASTERIA_TEST_CHECK(ref.read().check<D_array>().size() == 2);
+
+    const auto site = rocket::make_refcounted<Reference::S_site_cache>();
+    ref = Reference_root::S_temporary { D_null() };
+    ref.convert_to_variable(global);
+    for(int i = 0; i < 10; ++i) {
+      auto elem = ref;
+      elem.zoom_in(Reference_modifier::S_object_key(String::shallow("a")));
+      elem.zoom_in(Reference_modifier::S_array_index { i % 2 });
+      elem.share_site_cache(site);
+      elem.write(D_integer(i));
+    }
+    ref.zoom_in(Reference_modifier::S_object_key(String::shallow("a")));
+    ASTERIA_TEST_CHECK(site->parent == &(ref.peek(temp)));
+    ASTERIA_TEST_CHECK(ref.read().check<D_array>().at(0).check<D_integer>() == 8);
+    ASTERIA_TEST_CHECK(ref.read().check<D_array>().at(1).check<D_integer>() == 9);
+    ref.zoom_out();
+    auto other = Reference(Reference_root::S_temporary { D_null() });
+    other.convert_to_variable(global);
+    for(const auto &key : { "a", "b" }) {
+      auto elem = other;
+      elem.zoom_in(Reference_modifier::S_object_key(String::shallow(key)));
+      elem.zoom_in(Reference_modifier::S_array_index { 0 });
+      elem.share_site_cache(site);
+      elem.write(D_string(String::shallow(key)));
+    }
+    ASTERIA_TEST_CHECK(other.read().check<D_object>().at(String::shallow("a")).check<D_array>().at(0).check<D_string>() == "a");
+    ASTERIA_TEST_CHECK(other.read().check<D_object>().at(String::shallow("b")).check<D_array>().at(0).check<D_string>() == "b");
+    ASTERIA_TEST_CHECK(ref.read().check<D_object>().at(String::shallow("a")).check<D_array>().at(0).check<D_integer>() == 8);
+    auto inner = ref;
+    inner.zoom_in(Reference_modifier::S_object_key(String::shallow("a")));
+    inner.zoom_in(Reference_modifier::S_array_index { 0 });
+    inner.write(D_integer(1));
+    copy = ref.peek(temp);
+    inner.write(D_integer(2));
+    ASTERIA_TEST_CHECK(copy.check<D_object>().at(String::shallow("a")).check<D_array>().at(0).check<D_integer>() == 1);
+    ASTERIA_TEST_CHECK(ref.read().check<D_object>().at(String::shallow("a")).check<D_array>().at(0).check<D_integer>() == 2);
+
+    // Opening a string does not make its variable able to form a cycle.
+    Collector coll(0, nullptr, 100, 0);
+    const auto str = rocket::make_refcounted<Variable>(D_string(String::shallow("meow")), false);
+    ASTERIA_TEST_CHECK(coll.track_variable(str));
+    ASTERIA_TEST_CHECK(str->get_park_collector_opt() == &coll);
+    ref = Reference_root::S_variable { str };
+    ref.open_opt()->check<D_string>().append(D_string(String::shallow("!")));
+    ASTERIA_TEST_CHECK(str->get_value().check<D_string>() == "meow!");
+    ASTERIA_TEST_CHECK(str->get_park_collector_opt() == &coll);
+    ASTERIA_TEST_CHECK(coll.untrack_variable(str));
   }
@@ -22,4 +22,183 @@ int main()
     Global_context global;
     auto res = code.execute(global, { });
     ASTERIA_TEST_CHECK(res.read().check<D_integer>() == 90);
+
+    // Slices share storage with their operands.
+    iss.clear();
+    iss.str(R"__(
+      var s = "hello, world";
+      var a = [ 1, 2, 3, 4, 5 ];
+      var t = s[7:] + s[0:5] + s[-5:2];
+      t += t;
+      return (t == "worldhellowoworldhellowo") && (lengthof a[1:3] == 3) && (a[1:3][2] == 4) && (lengthof a[5:] == 0);
+    )__");
+    Simple_source_file slice(iss, String::shallow("my_file"));
+    ASTERIA_TEST_CHECK(slice.execute(global, { }).read().check<D_boolean>() == true);
+
+    // Compound assignments modify their targets in place where possible.
+    iss.clear();
+    iss.str(R"__(
+      var s = "ab";
+      s *= 3;
+      s += s;
+      var t = "q";
+      t *= 0;
+      var o;
+      o.n = 1;
+      o.r = 1.5;
+      o.s = "x";
+      var a = [ 1, 2, 3 ];
+      for(var i = 0; i < 10; ++i) {
+        o.n += i;
+        o.r *= 2.0;
+        o.s += "y";
+        a[i % 3] += i;
+      }
+      o.n -= 5;
+      o.n *= 2;
+      o.n /= 3;
+      o.n %= 7;
+      return (s == "abababababab") && (t == "") && (o.n == 6) && (o.r == 1536.0) && (o.s == "xyyyyyyyyyy") &&
+             (a[0] == 19) && (a[1] == 14) && (a[2] == 18);
+    )__");
+    Simple_source_file compound(iss, String::shallow("my_file"));
+    ASTERIA_TEST_CHECK(compound.execute(global, { }).read().check<D_boolean>() == true);
+
+    // A slice is not modified by later writes to its operand.
+    iss.clear();
+    iss.str(R"__(
+      var a = [ ];
+      for(var i = 0; i < 100; ++i) {
+        a[i] = [ 1, 2 ];
+      }
+      var x;
+      for(var i = 0; i < 2; ++i) {
+        a[0][1] = i + 10;
+        if(i == 0) {
+          x = a[0:50];
+        }
+      }
+      return x[0][1];
+    )__");
+    Simple_source_file slice_write(iss, String::shallow("my_file"));
+    ASTERIA_TEST_CHECK(slice_write.execute(global, { }).read().check<D_integer>() == 10);
+
+    // Variables that are only reachable from closures shall survive garbage collection. Every `x` forms a cycle, so it is
+    // tracked, and one in ten of them survives into generation two.
+    static const char s_closure[] = R"__(
+      var f;
+      {
+        var b = [ 42, null ];
+        b[1] = func() { return b; };
+        f = func() { return b[1]()[0]; };
+      }
+      var keep = [ ];
+      for(var i = 0; i < 3000; ++i) {
+        var x = [ i, null ];
+        x[1] = func() { return x; };
+        if(i % 10 == 0) {
+          keep[lengthof keep] = x;
+        }
+      }
+      var sum = f();
+      for(var i = 0; i < lengthof keep; ++i) {
+        sum = sum + keep[i][1]()[0];
+      }
+      return sum;
+    )__";
+    for(Size limit = 0; limit < 20; limit += 7) {
+      iss.clear();
+      iss.str(s_closure);
+      Simple_source_file closure(iss, String::shallow("my_file"));
+      Global_context global_closure;
+      global_closure.set_garbage_collection_step_limits(limit, 0);
+      global_closure.set_concurrent_garbage_collection(limit != 0);
+      res = closure.execute(global_closure, { });
+      ASTERIA_TEST_CHECK(res.read().check<D_integer>() == 448542);
+      // Survivors shall have been examined by generation two. Collections shall have been performed in steps if a
+      // limit is set.
+      const auto stats = global_closure.get_garbage_collection_statistics(0);
+      ASTERIA_TEST_CHECK(stats.collections > 0);
+      ASTERIA_TEST_CHECK(stats.variables_promoted > 0);
+      ASTERIA_TEST_CHECK((stats.pauses > stats.collections) == (limit != 0));
+      ASTERIA_TEST_CHECK(global_closure.get_garbage_collection_statistics(1).variables_promoted > 0);
+      ASTERIA_TEST_CHECK(global_closure.get_garbage_collection_statistics(2).variables_examined > 0);
+      // Only collections of generation two shall have been performed concurrently.
+      ASTERIA_TEST_CHECK(stats.collections_concurrent == 0);
+      ASTERIA_TEST_CHECK((global_closure.get_garbage_collection_statistics(2).collections_concurrent > 0) == (limit != 0));
+    }
+
+    // A function that is shared by multiple variables refers to the variables that it captures only once. Variables
+    // that are reachable from older generations shall survive.
+    static const char s_shared[] = R"__(
+      var keep = [ ];
+      for(var i = 0; i < 5000; ++i) {
+        var x = [ i, null ];
+        x[1] = func() { return x; };
+        var y = { a = x, b = null };
+        if(i % 3 == 0) {
+          keep[lengthof keep] = func() { return x; };
+        }
+      }
+      return keep[56]()[0];
+    )__";
+    for(Size limit = 0; limit < 100; limit += 50) {
+      iss.clear();
+      iss.str(s_shared);
+      Simple_source_file shared(iss, String::shallow("my_file"));
+      Global_context global_shared;
+      global_shared.set_garbage_collection_step_limits(limit, 0);
+      res = shared.execute(global_shared, { });
+      ASTERIA_TEST_CHECK(res.read().check<D_integer>() == 168);
+    }
+
+    // Cycles shall be broken when a context is torn down without garbage collection.
+    static const char s_cycle[] = R"__(
+      var a = [ null ];
+      a[0] = func() { return a; };
+      for(var i = 0; i < 2000; ++i) {
+        var x = [ i ];
+        x[0] = func() { return x; };
+      }
+      return & a;
+    )__";
+    for(Size limit = 0; limit < 20; limit += 7) {
+      iss.clear();
+      iss.str(s_cycle);
+      Simple_source_file cycle(iss, String::shallow("my_file"));
+      Reference ref;
+      {
+        Global_context global_cycle;
+        global_cycle.set_fast_teardown(true);
+        global_cycle.set_garbage_collection_step_limits(limit, 0);
+        global_cycle.set_concurrent_garbage_collection(limit != 0);
+        ASTERIA_TEST_CHECK(global_cycle.is_fast_teardown());
+        ref = cycle.execute(global_cycle, { });
+        const auto value = ref.read();
+        ASTERIA_TEST_CHECK(value.check<D_array>().size() == 1);
+        ASTERIA_TEST_CHECK(value.check<D_array>().at(0).type() == Value::type_function);
+      }
+      // The variable is still referenced from outside, but its value shall have been wiped out.
+      ASTERIA_TEST_CHECK(ref.read().type() == Value::type_null);
+    }
+
+    // Cycles shall be collected by examining buffered variables only, and variables that are reachable from closures
+    // shall survive.
+    for(const auto src : { s_closure, s_cycle }) {
+      iss.clear();
+      iss.str(src);
+      Simple_source_file candidate(iss, String::shallow("my_file"));
+      Global_context global_candidate;
+      global_candidate.set_candidate_garbage_collection(50);
+      const auto value = candidate.execute(global_candidate, { }).read();
+      ASTERIA_TEST_CHECK(global_candidate.get_garbage_collection_statistics(2).collections == 0);
+      if(src == s_closure) {
+        ASTERIA_TEST_CHECK(value.check<D_integer>() == 448542);
+        continue;
+      }
+      ASTERIA_TEST_CHECK(value.check<D_array>().at(0).type() == Value::type_function);
+      const auto stats = global_candidate.get_garbage_collection_statistics(0);
+      ASTERIA_TEST_CHECK(stats.collections > 0);
+      ASTERIA_TEST_CHECK(stats.variables_freed > 0);
+    }
   }
@@ -26,14 +26,177 @@ int main()
     ASTERIA_TEST_CHECK(value.type() == Value::type_string);
     ASTERIA_TEST_CHECK(value.check<D_string>() == String::shallow("hello"));
 
+    // Short strings are stored in-place, and are never shared.
+    const auto small_cap = String(1, 'a').capacity();
+    ASTERIA_TEST_CHECK(small_cap == sizeof(void *) * 3 - 2);
+    String sso(small_cap, 'a');
+    ASTERIA_TEST_CHECK(sso.capacity() == small_cap);
+    ASTERIA_TEST_CHECK(static_cast<const void *>(sso.data()) >= static_cast<const void *>(&sso));
+    ASTERIA_TEST_CHECK(static_cast<const void *>(sso.data()) < static_cast<const void *>(&sso + 1));
+    String sso_copy = sso;
+    ASTERIA_TEST_CHECK(sso.unique() && sso_copy.unique());
+    ASTERIA_TEST_CHECK(sso_copy.data() != sso.data());
+    sso.push_back('b');
+    ASTERIA_TEST_CHECK(sso.size() == small_cap + 1);
+    ASTERIA_TEST_CHECK(sso.capacity() > small_cap);
+    ASTERIA_TEST_CHECK(sso.substr(small_cap) == String::shallow("b"));
+    ASTERIA_TEST_CHECK(sso_copy == String(small_cap, 'a'));
+    String heap_copy = sso;
+    ASTERIA_TEST_CHECK(heap_copy.data() == sso.data());
+    ASTERIA_TEST_CHECK(!sso.unique() && !heap_copy.unique());
+    heap_copy.mut(0) = 'c';
+    ASTERIA_TEST_CHECK(sso.unique() && heap_copy.unique());
+    ASTERIA_TEST_CHECK(sso[0] == 'a');
+
+    String str(100, 'a');
+    str.append("hello");
+    String suffix = str.substr(50);
+    ASTERIA_TEST_CHECK(suffix.size() == 55);
+    ASTERIA_TEST_CHECK(suffix.data() == str.data() + 50);
+    ASTERIA_TEST_CHECK(String::traits_type::length(suffix.c_str()) == 55);
+    // A shared suffix has to be reallocated before it is modified, even if nothing else refers to its storage.
+    ASTERIA_TEST_CHECK(!suffix.unique());
+    ASTERIA_TEST_CHECK(!str.unique());
+    String long_suffix = str.substr(105 - (small_cap + 1));
+    ASTERIA_TEST_CHECK(long_suffix.data() == str.data() + 105 - (small_cap + 1));
+    String short_suffix = str.substr(105 - small_cap);
+    ASTERIA_TEST_CHECK(short_suffix.data() != str.data() + 105 - small_cap);
+    ASTERIA_TEST_CHECK(short_suffix.capacity() == small_cap);
+    ASTERIA_TEST_CHECK(short_suffix.unique());
+    long_suffix = String();
+    String orphan = str.substr(50);
+    str = String();
+    ASTERIA_TEST_CHECK(!orphan.unique());
+    str = String(100, 'a');
+    str.append("hello");
+    suffix.mut(54) = '!';
+    ASTERIA_TEST_CHECK(suffix.substr(50) == String::shallow("hell!"));
+    ASTERIA_TEST_CHECK(str.substr(100) == String::shallow("hello"));
+
+    D_string rope(String::shallow("x"));
+    D_string prefix = rope;
+    for(int i = 0; i < 1000; ++i) {
+      rope.append(D_string(String::shallow("abc")));
+      if(i == 500) {
+        prefix = rope;
+      }
+    }
+    ASTERIA_TEST_CHECK(rope.mode() == D_string::mode_rope);
+    ASTERIA_TEST_CHECK(rope.size() == 3001);
+    prefix.append(prefix);
+    ASTERIA_TEST_CHECK(prefix.size() == 3008);
+    ASTERIA_TEST_CHECK(rope.flatten().substr(2998) == String::shallow("abc"));
+    ASTERIA_TEST_CHECK(rope.mode() == D_string::mode_flat);
+    ASTERIA_TEST_CHECK(prefix.flatten().substr(1502, 3) == String::shallow("bcx"));
+
+    D_string whole(String(100, 'a') + "hello world");
+    D_string sub = whole.substr(60, 45);
+    ASTERIA_TEST_CHECK(sub.mode() == D_string::mode_rope);
+    ASTERIA_TEST_CHECK(sub.size() == 45);
+    D_string subsub = sub.substr(1, 43);
+    ASTERIA_TEST_CHECK(subsub.mode() == D_string::mode_rope);
+    ASTERIA_TEST_CHECK(subsub.size() == 43);
+    sub.append(D_string(String::shallow("!")));
+    ASTERIA_TEST_CHECK(sub.substr(40) == String::shallow("hello!"));
+    ASTERIA_TEST_CHECK(subsub.substr(39) == String::shallow("hell"));
+    D_string short_sub = whole.substr(100, 5);
+    ASTERIA_TEST_CHECK(short_sub.mode() == D_string::mode_flat);
+    ASTERIA_TEST_CHECK(short_sub == String::shallow("hello"));
+    ASTERIA_TEST_CHECK(sub.substr(40).mode() == D_string::mode_flat);
+    ASTERIA_TEST_CHECK(whole.substr(106) == String::shallow("world"));
+    ASTERIA_TEST_CHECK(whole.substr(111).empty());
+    ASTERIA_TEST_CHECK(whole.size() == 111);
+
     D_array array;
-    array.emplace_back(D_boolean(true));
-    array.emplace_back(D_string("world"));
+    array.push_back(D_boolean(true));
+    array.push_back(D_string("world"));
     value = std::move(array);
     ASTERIA_TEST_CHECK(value.type() == Value::type_array);
     ASTERIA_TEST_CHECK(value.check<D_array>().at(0).check<D_boolean>() == true);
     ASTERIA_TEST_CHECK(value.check<D_array>().at(1).check<D_string>() == String::shallow("world"));
 
+    array = value.check<D_array>();
+    for(int i = 0; i < 2000; ++i) {
+      array.push_back(D_integer(i));
+    }
+    array.insert(1000, D_string("middle"));
+    ASTERIA_TEST_CHECK(array.size() == 2003);
+    D_array sliced = array.subarray(990, 20);
+    ASTERIA_TEST_CHECK(sliced.size() == 20);
+    ASTERIA_TEST_CHECK(sliced.at(9).check<D_integer>() == 997);
+    ASTERIA_TEST_CHECK(sliced.at(10).check<D_string>() == String::shallow("middle"));
+    sliced.mut(0) = D_boolean(false);
+    array.erase(0);
+    ASTERIA_TEST_CHECK(array.size() == 2002);
+    ASTERIA_TEST_CHECK(array.at(989).check<D_integer>() == 988);
+    ASTERIA_TEST_CHECK(array.at(999).check<D_string>() == String::shallow("middle"));
+    ASTERIA_TEST_CHECK(array.at(2001).check<D_integer>() == 1999);
+    ASTERIA_TEST_CHECK(value.check<D_array>().size() == 2);
+
+    Persistent_vector<Value> elems;
+    elems.push_back(D_integer(1));
+    elems.insert(elems.begin(), { });
+    elems.insert(elems.end(), elems.begin(), elems.begin());
+    ASTERIA_TEST_CHECK(elems.size() == 1);
+
+    array.clear();
+    for(int i = 0; i < 100; ++i) {
+      array.push_back(D_integer(i - 20));
+    }
+    ASTERIA_TEST_CHECK(array.mode() == D_array::mode_integer);
+    ASTERIA_TEST_CHECK(array.sum().check<D_integer>() == 2950);
+    ASTERIA_TEST_CHECK(array.min().check<D_integer>() == -20);
+    ASTERIA_TEST_CHECK(array.max().check<D_integer>() == 79);
+    ASTERIA_TEST_CHECK(array.dot(array).check<D_integer>() == 170350);
+    sliced = array.subarray(10, 20);
+    ASTERIA_TEST_CHECK(sliced.mode() == D_array::mode_integer);
+    ASTERIA_TEST_CHECK(sliced.opt<D_array::S_unboxed<D_integer>>()->elems.data() == array.opt<D_array::S_unboxed<D_integer>>()->elems.data());
+    ASTERIA_TEST_CHECK(sliced.sum().check<D_integer>() == -10);
+    sliced.erase(0);
+    sliced.set(0, D_integer(42));
+    ASTERIA_TEST_CHECK(sliced.size() == 19);
+    ASTERIA_TEST_CHECK(sliced.at(0).check<D_integer>() == 42);
+    ASTERIA_TEST_CHECK(array.at(11).check<D_integer>() == -9);
+
+    // A queue keeps reusing its buffer.
+    D_array queue;
+    for(int i = 0; i < 10; ++i) {
+      queue.push_back(D_integer(i));
+    }
+    queue.erase(0);
+    queue.push_back(D_integer(10));
+    ASTERIA_TEST_CHECK(queue.opt<D_array::S_unboxed<D_integer>>()->off == 1);
+    queue.erase(0);
+    queue.push_back(D_integer(11));
+    ASTERIA_TEST_CHECK(queue.opt<D_array::S_unboxed<D_integer>>()->off == 2);
+    for(int i = 12; i < 1000; ++i) {
+      ASTERIA_TEST_CHECK(queue.erase(0).check<D_integer>() == i - 10);
+      queue.push_back(D_integer(i));
+    }
+    ASTERIA_TEST_CHECK(queue.size() == 10);
+    ASTERIA_TEST_CHECK(queue.at(0).check<D_integer>() == 990);
+    ASTERIA_TEST_CHECK(queue.opt<D_array::S_unboxed<D_integer>>()->elems.size() <= 21);
+    sliced = array;
+    sliced.scale(D_integer(3));
+    ASTERIA_TEST_CHECK(sliced.at(99).check<D_integer>() == 237);
+    ASTERIA_TEST_CHECK(array.at(99).check<D_integer>() == 79);
+    array.set(0, D_integer(1));
+    ASTERIA_TEST_CHECK(array.mode() == D_array::mode_integer);
+    array.set(1, D_real(0.5));
+    ASTERIA_TEST_CHECK(array.mode() == D_array::mode_generic);
+    ASTERIA_TEST_CHECK(array.at(0).check<D_integer>() == 1);
+    ASTERIA_TEST_CHECK(array.at(1).check<D_real>() == 0.5);
+    ASTERIA_TEST_CHECK(array.sum().check<D_real>() == 2990.5);
+    array.scale(D_real(2));
+    ASTERIA_TEST_CHECK(array.mode() == D_array::mode_real);
+    ASTERIA_TEST_CHECK(array.at(2).check<D_real>() == -36);
+    array.clear();
+    array.push_back(D_integer(std::numeric_limits<D_integer>::max()));
+    array.push_back(D_integer(1));
+    ASTERIA_TEST_CHECK_CATCH(array.sum());
+    array.push_back(D_integer(-2));
+    ASTERIA_TEST_CHECK(array.sum().check<D_integer>() == std::numeric_limits<D_integer>::max() - 1);
+
     D_object object;
     object.try_emplace(String::shallow("one"), D_boolean(true));
     object.try_emplace(String::shallow("two"), D_string("world"));
@@ -41,6 +204,97 @@ int main()
     ASTERIA_TEST_CHECK(value.type() == Value::type_object);
     ASTERIA_TEST_CHECK(value.check<D_object>().at(String::shallow("one")).check<D_boolean>() == true);
     ASTERIA_TEST_CHECK(value.check<D_object>().at(String::shallow("two")).check<D_string>() == String::shallow("world"));
+    ASTERIA_TEST_CHECK(value.check<D_object>().mode() == D_object::mode_flat);
+
+    object = value.check<D_object>();
+    for(int i = 0; i < 20; ++i) {
+      object.insert_or_assign(String(1, static_cast<char>('a' + i)), D_integer(i));
+    }
+    object.erase(String::shallow("one"));
+    ASTERIA_TEST_CHECK(object.size() == 21);
+    ASTERIA_TEST_CHECK(object.at(String::shallow("t")).check<D_integer>() == 19);
+    ASTERIA_TEST_CHECK(object.at(String::shallow("two")).check<D_string>() == String::shallow("world"));
+    ASTERIA_TEST_CHECK(object.mode() == D_object::mode_trie);
+    ASTERIA_TEST_CHECK(value.check<D_object>().size() == 2);
+    ASTERIA_TEST_CHECK(value.check<D_object>().mode() == D_object::mode_flat);
+
+    for(int i = 0; i < 1000; ++i) {
+      object.insert_or_assign(String(3, static_cast<char>('a' + i % 26)) + String(1, static_cast<char>('a' + i / 26)), D_integer(i));
+    }
+    ASTERIA_TEST_CHECK(object.size() == 1021);
+    D_object shared = object;
+    shared.mut(String::shallow("two")) = D_integer(42);
+    shared.erase(String::shallow("aaab"));
+    ASTERIA_TEST_CHECK(shared.size() == 1020);
+    ASTERIA_TEST_CHECK(shared.at(String::shallow("two")).check<D_integer>() == 42);
+    ASTERIA_TEST_CHECK(object.size() == 1021);
+    ASTERIA_TEST_CHECK(object.at(String::shallow("two")).check<D_string>() == String::shallow("world"));
+    ASTERIA_TEST_CHECK(object.at(String::shallow("aaab")).check<D_integer>() == 26);
+
+    shared = object;
+    long visited = 0;
+    long erased = 0;
+    for(auto it = shared.begin(); it != shared.end(); ) {
+      visited += 1;
+      if(it->second.type() != Value::type_integer) {
+        ++it;
+        continue;
+      }
+      if(it->second.check<D_integer>() % 2 != 0) {
+        ++it;
+        continue;
+      }
+      it = shared.erase(it);
+      erased += 1;
+    }
+    ASTERIA_TEST_CHECK(visited == 1021);
+    ASTERIA_TEST_CHECK(shared.size() == static_cast<std::size_t>(1021 - erased));
+    visited = 0;
+    for(auto it = shared.begin(); it != shared.end(); ) {
+      visited += 1;
+      it = shared.erase(it);
+    }
+    ASTERIA_TEST_CHECK(visited == 1021 - erased);
+    ASTERIA_TEST_CHECK(shared.empty());
+    shared.clear();
+    ASTERIA_TEST_CHECK(shared.mode() == D_object::mode_flat);
+    for(int n = 1; n < 200; ++n) {
+      for(int m = 2; m < 8; ++m) {
+        // Emptying a leaf may collapse its parent into a sibling leaf that has been visited. Make sure no element is visited twice.
+        shared.clear();
+        for(int i = 0; i < n; ++i) {
+          shared.insert_or_assign(String(2, static_cast<char>('a' + i % 26)) + String(1, static_cast<char>('a' + i / 26)), D_integer(i));
+        }
+        visited = 0;
+        for(auto it = shared.begin(); it != shared.end(); ) {
+          visited += 1;
+          if(it->second.check<D_integer>() % m == 0) {
+            ++it;
+            continue;
+          }
+          it = shared.erase(it);
+        }
+        ASTERIA_TEST_CHECK(visited == n);
+        ASTERIA_TEST_CHECK(shared.size() == static_cast<std::size_t>((n + m - 1) / m));
+      }
+    }
+    for(int n = 1; n <= 8; ++n) {
+      // Erasing from a flat table that is shared with another object copies it. Make sure no element is visited twice.
+      shared.clear();
+      for(int i = 0; i < n; ++i) {
+        shared.insert_or_assign(String(1, static_cast<char>('a' + i)), D_integer(i));
+      }
+      const auto copy = shared;
+      visited = 0;
+      for(auto it = shared.begin(); it != shared.end(); ) {
+        visited += 1;
+        it = (it->second.check<D_integer>() % 2 == 0) ? std::next(it) : shared.erase(it);
+      }
+      ASTERIA_TEST_CHECK(visited == n);
+      ASTERIA_TEST_CHECK(shared.size() == static_cast<std::size_t>((n + 1) / 2));
+      ASTERIA_TEST_CHECK(copy.size() == static_cast<std::size_t>(n));
+    }
+    ASTERIA_TEST_CHECK(object.size() == 1021);
 
     value = nullptr;
     Value cmp(nullptr);
@@ -102,8 +356,8 @@ int main()
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_greater);
 
     array.clear();
-    array.emplace_back(D_boolean(true));
-    array.emplace_back(D_string("world"));
+    array.push_back(D_boolean(true));
+    array.push_back(D_string("world"));
     value = array;
     cmp = std::move(array);
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_equal);
@@ -119,7 +373,7 @@ int main()
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_unordered);
     std::swap(value, cmp);
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_unordered);
-    value.check<D_array>().erase(std::prev(value.check<D_array>().end()));
+    value.check<D_array>().erase(1);
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_less);
 
     object.clear();
@@ -130,4 +384,33 @@ int main()
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_unordered);
     std::swap(value, cmp);
     ASTERIA_TEST_CHECK(value.compare(cmp) == Value::compare_unordered);
+
+    // Containers of scalars cannot contain variables.
+    ASTERIA_TEST_CHECK(value.may_contain_variables() == false);
+    array.clear();
+    array.push_back(D_string("hello"));
+    array.push_back(value);
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == false);
+    // Elements that are handed out for modification are checked again.
+    array.mut(0) = D_integer(1);
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == false);
+    object.clear();
+    object.insert_or_assign(String::shallow("scalars"), value);
+    ASTERIA_TEST_CHECK(object.may_contain_variables() == false);
+    object.mut(String::shallow("scalars")) = D_null();
+    ASTERIA_TEST_CHECK(object.may_contain_variables() == true);
+    array.mut(1) = object;
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == true);
+    array.mut(0) = D_integer(2);
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == true);
+    object.clear();
+    object.insert_or_assign(String::shallow("unknown"), array);
+    ASTERIA_TEST_CHECK(object.may_contain_variables() == true);
+    array.clear();
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == false);
+    array.push_back(D_integer(1));
+    array.push_back(D_integer(2));
+    array.mut(0) = D_integer(3);
+    array.mut(1) = D_real(4.5);
+    ASTERIA_TEST_CHECK(array.may_contain_variables() == false);
   }
@@ -3,9 +3,30 @@
 
 #include "_test_init.hpp"
 #include "../asteria/src/variable.hpp"
+#include "../asteria/src/collector.hpp"
+#include "../asteria/src/variable_pool.hpp"
+#include "../asteria/src/abstract_collection_callback.hpp"
 
 using namespace Asteria;
 
+namespace {
+
+class Counting_callback : public Abstract_collection_callback
+  {
+  public:
+    mutable Uint64 freed = 0;
+
+  public:
+    void accept(unsigned gen, const Collection_statistics &stats) const override
+      {
+        ASTERIA_TEST_CHECK(gen == 0);
+        ASTERIA_TEST_CHECK(stats.collections == 1);
+        this->freed += stats.variables_freed;
+      }
+  };
+
+}
+
 int main()
   {
     const auto var = rocket::make_refcounted<Variable>(D_real(123.456), false);
@@ -14,4 +35,76 @@ int main()
     ASTERIA_TEST_CHECK(var->get_value().type() == Value::type_string);
     var->reset(D_integer(42), true);
     ASTERIA_TEST_CHECK_CATCH(var->set_value(D_null()));
+
+    // Variables that cannot form cycles are not tracked until they may.
+    Collector coll(0, nullptr, 100, 0);
+    const auto other = rocket::make_refcounted<Variable>(D_integer(1), false);
+    ASTERIA_TEST_CHECK(coll.track_variable(other));
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == &coll);
+    D_array array;
+    array.push_back(D_integer(2));
+    other->set_value(array);
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == &coll);
+    array.mut(0) = D_integer(3);
+    other->set_value(array);
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == &coll);
+    D_object object;
+    object.insert_or_assign(String::shallow("unknown"), D_null());
+    object.mut(String::shallow("unknown")) = D_integer(4);
+    array.mut(0) = object;
+    other->set_value(array);
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == nullptr);
+    other->get_value().check<D_array>().clear();
+    coll.collect();
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == &coll);
+    ASTERIA_TEST_CHECK(coll.untrack_variable(other));
+    ASTERIA_TEST_CHECK(other->get_park_collector_opt() == nullptr);
+
+    // Thresholds are increased if most variables survive, and are decreased if few do.
+    Collector adapt(0, nullptr, 4, 10000);
+    Counting_callback callback;
+    adapt.set_callback_opt(&callback);
+    adapt.set_adaptive(true);
+    // The array holds an object that may contain variables, so these variables are not parked.
+    ASTERIA_TEST_CHECK(array.may_contain_variables());
+    Vector<rocket::refcounted_ptr<Variable>> vars;
+    for(int i = 0; i < 4; ++i) {
+      vars.emplace_back(rocket::make_refcounted<Variable>(array, false));
+      ASTERIA_TEST_CHECK(adapt.track_variable(vars.back()));
+    }
+    adapt.collect();
+    ASTERIA_TEST_CHECK(adapt.get_threshold() == 8);
+    ASTERIA_TEST_CHECK(adapt.get_byte_threshold() == 20000);
+    vars.clear();
+    adapt.collect();
+    ASTERIA_TEST_CHECK(adapt.get_threshold() == 4);
+    ASTERIA_TEST_CHECK(adapt.get_byte_threshold() == 10000);
+    // Statistics are accumulated over collections, and are passed to the callback after each of them.
+    ASTERIA_TEST_CHECK(adapt.get_statistics().collections == 2);
+    ASTERIA_TEST_CHECK(adapt.get_statistics().pauses == 2);
+    ASTERIA_TEST_CHECK(adapt.get_statistics().variables_examined == 8);
+    ASTERIA_TEST_CHECK(adapt.get_statistics().variables_freed == 4);
+    ASTERIA_TEST_CHECK(adapt.get_statistics().bytes_freed >= 4 * sizeof(Variable));
+    ASTERIA_TEST_CHECK(adapt.get_last_statistics().variables_freed == 4);
+    ASTERIA_TEST_CHECK(callback.freed == 4);
+    // A collection is triggered by a variable with a large value.
+    for(int i = 0; i < 1000; ++i) {
+      array.push_back(D_integer(i));
+    }
+    const auto large = rocket::make_refcounted<Variable>(array, false);
+    ASTERIA_TEST_CHECK(adapt.track_variable(large));
+    ASTERIA_TEST_CHECK(adapt.get_threshold() == 8);
+
+    // Variables are allocated from slabs, and storage of destroyed variables is reused.
+    const auto pool = rocket::make_refcounted<Variable_pool>();
+    auto first = pool->create_variable();
+    auto second = pool->create_variable();
+    ASTERIA_TEST_CHECK(first->as_deleter().get_pool_opt() == pool.get());
+    ASTERIA_TEST_CHECK(pool->get_free_count() == pool->get_capacity() - 2);
+    const auto addr = static_cast<void *>(first.get());
+    first.reset();
+    ASTERIA_TEST_CHECK(pool->get_free_count() == pool->get_capacity() - 1);
+    first = pool->create_variable();
+    ASTERIA_TEST_CHECK(static_cast<void *>(first.get()) == addr);
+    ASTERIA_TEST_CHECK(var->as_deleter().get_pool_opt() == nullptr);
   }